@@ -78,6 +78,7 @@ void Autocomplete::run() {
 
       auto &buffer_raw = const_cast<std::string &>(buffer.raw());
       rows.clear();
+      rows_truncated = false;
       add_rows(buffer_raw, line_nr, column_nr);
 
       if(is_processing()) {
@@ -136,6 +137,8 @@ void Autocomplete::stop() {
 }
 
 void Autocomplete::setup_dialog() {
+  CompletionDialog::get()->fuzzy_match = fuzzy_match;
+
   CompletionDialog::get()->on_show = [this] {
     on_show();
   };
@@ -148,6 +151,27 @@ void Autocomplete::setup_dialog() {
     reparse();
   };
 
+  CompletionDialog::get()->on_search_entry_changed = [this](const std::string &text) {
+    if(!refilter_rows)
+      return;
+    {
+      LockGuard lock(prefix_mutex);
+      // The rows contain all matches of an extended prefix, unless they were truncated
+      if(!rows_truncated && text.compare(0, prefix.bytes(), prefix.raw()) == 0)
+        return;
+      prefix = text;
+    }
+    rows.clear();
+    rows_truncated = false;
+    refilter_rows();
+    CompletionDialog::get()->erase_rows();
+    for(auto &row : rows) {
+      CompletionDialog::get()->add_row(row);
+      row.clear();
+    }
+    CompletionDialog::get()->set_cursor_at_first_row();
+  };
+
   CompletionDialog::get()->on_changed = [this](unsigned int index, const std::string &text) {
     if(index >= rows.size()) {
       tooltips.hide();
@@ -20,6 +20,12 @@ public:
   Mutex prefix_mutex;
   Glib::ustring prefix GUARDED_BY(prefix_mutex);
   std::vector<std::string> rows;
+  /// Set to true in add_rows or refilter_rows if only the best matching rows were added.
+  /// If so, refilter_rows is called when the prefix changes while the completion dialog is shown.
+  /// Otherwise, refilter_rows is only called when the prefix is shortened or replaced.
+  bool rows_truncated = false;
+  /// Set to true if the completion dialog should fuzzy match the rows, see CompletionDialog::fuzzy_match
+  bool fuzzy_match = false;
   Tooltips tooltips;
 
   std::atomic<State> state = {State::IDLE};
@@ -42,6 +48,9 @@ public:
 
   /// The handler is not run in the main loop.
   std::function<void(std::string &buffer, int line_number, int column)> add_rows = [](std::string &, int, int) {};
+  /// If set, replaces rows with the best matches of the current prefix. The handler is run in the main loop,
+  /// and should therefore only filter previously found rows.
+  std::function<void()> refilter_rows;
 
   std::function<void()> on_show = [] {};
   std::function<void()> on_hide = [] {};
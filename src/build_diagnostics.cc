@@ -0,0 +1,166 @@
+#include "build_diagnostics.h"
+#include <cstring>
+
+BuildDiagnostics::Diagnostic *BuildDiagnostics::add_line(const std::string &line) {
+  Diagnostic diagnostic;
+  if(parse_gcc(line, diagnostic) || parse_msvc(line, diagnostic)) {
+    rust_diagnostic.reset();
+    if(diagnostic.severity == Diagnostic::Severity::NOTE) {
+      if(!diagnostics.empty())
+        diagnostics.back().notes.emplace_back(std::move(diagnostic));
+      return nullptr;
+    }
+    diagnostics.emplace_back(std::move(diagnostic));
+    return &diagnostics.back();
+  }
+
+  // Rust gives the location in the line after the error or warning, for instance "  --> src/main.rs:2:5"
+  if(rust_diagnostic) {
+    size_t pos = 0;
+    while(pos < line.size() && line[pos] == ' ')
+      ++pos;
+    if(pos > 0 && starts_with(line, pos, "--> ")) {
+      pos += 4;
+      auto path_end = line.find(':', pos + (line.size() > pos + 1 && line[pos + 1] == ':' ? 2 : 0));
+      if(path_end != std::string::npos && path_end > pos) {
+        auto number_pos = path_end + 1;
+        if(parse_number(line, number_pos, rust_diagnostic->line) && starts_with(line, number_pos, ":") &&
+           parse_number(line, ++number_pos, rust_diagnostic->line_offset) && number_pos == line.size()) {
+          rust_diagnostic->path = line.substr(pos, path_end - pos);
+          diagnostics.emplace_back(std::move(*rust_diagnostic));
+          rust_diagnostic.reset();
+          return &diagnostics.back();
+        }
+      }
+    }
+    rust_diagnostic.reset();
+  }
+  if(parse_severity(line, 0, diagnostic) && diagnostic.severity != Diagnostic::Severity::NOTE)
+    rust_diagnostic = std::make_unique<Diagnostic>(std::move(diagnostic));
+  return nullptr;
+}
+
+void BuildDiagnostics::clear() {
+  diagnostics.clear();
+  resolved_paths.clear();
+  current = -1;
+  rust_diagnostic.reset();
+}
+
+const BuildDiagnostics::Diagnostic *BuildDiagnostics::next() {
+  if(diagnostics.empty())
+    return nullptr;
+  current = current + 1 < diagnostics.size() ? current + 1 : 0;
+  return &diagnostics[current];
+}
+
+const BuildDiagnostics::Diagnostic *BuildDiagnostics::previous() {
+  if(diagnostics.empty())
+    return nullptr;
+  current = current != static_cast<size_t>(-1) && current > 0 ? current - 1 : diagnostics.size() - 1;
+  return &diagnostics[current];
+}
+
+bool BuildDiagnostics::parse_gcc(const std::string &line, Diagnostic &diagnostic) {
+  // Skip Windows drive
+  size_t pos = line.size() > 2 && line[0] >= 'A' && line[0] <= 'Z' && line[1] == ':' ? 2 : 0;
+  auto path_end = line.find(':', pos);
+  if(path_end == std::string::npos || path_end == 0)
+    return false;
+  pos = path_end + 1;
+  if(!parse_number(line, pos, diagnostic.line) || !starts_with(line, pos, ":"))
+    return false;
+  ++pos;
+  if(is_digit(line, pos)) {
+    if(!parse_number(line, pos, diagnostic.line_offset) || !starts_with(line, pos, ":"))
+      return false;
+    ++pos;
+  }
+  else
+    diagnostic.line_offset = 1;
+  if(!starts_with(line, pos, " ") || !parse_severity(line, pos + 1, diagnostic))
+    return false;
+  diagnostic.path = line.substr(0, path_end);
+  return true;
+}
+
+bool BuildDiagnostics::parse_msvc(const std::string &line, Diagnostic &diagnostic) {
+  // The path can contain parentheses, for instance C:\Program Files (x86)\...
+  for(auto open = line.find('('); open != std::string::npos; open = line.find('(', open + 1)) {
+    if(open == 0)
+      continue;
+    auto pos = open + 1;
+    if(!parse_number(line, pos, diagnostic.line))
+      continue;
+    diagnostic.line_offset = 1;
+    if(starts_with(line, pos, ",") && !parse_number(line, ++pos, diagnostic.line_offset))
+      continue;
+    if(!starts_with(line, pos, "): ") || !parse_severity(line, pos + 3, diagnostic))
+      continue;
+    diagnostic.path = line.substr(0, open);
+    return true;
+  }
+  return false;
+}
+
+bool BuildDiagnostics::parse_severity(const std::string &line, size_t pos, Diagnostic &diagnostic) {
+  if(starts_with(line, pos, "fatal error")) {
+    diagnostic.severity = Diagnostic::Severity::ERROR;
+    pos += 11;
+  }
+  else if(starts_with(line, pos, "error")) {
+    diagnostic.severity = Diagnostic::Severity::ERROR;
+    pos += 5;
+  }
+  else if(starts_with(line, pos, "warning")) {
+    diagnostic.severity = Diagnostic::Severity::WARNING;
+    pos += 7;
+  }
+  else if(starts_with(line, pos, "note")) {
+    diagnostic.severity = Diagnostic::Severity::NOTE;
+    pos += 4;
+  }
+  else
+    return false;
+
+  // Skip Rust code, for instance [E0425], or MSVC code, for instance C2065
+  if(starts_with(line, pos, "[")) {
+    pos = line.find(']', pos);
+    if(pos == std::string::npos)
+      return false;
+    ++pos;
+  }
+  else if(starts_with(line, pos, " ")) {
+    auto code_end = pos + 1;
+    while(code_end < line.size() && ((line[code_end] >= 'A' && line[code_end] <= 'Z') || is_digit(line, code_end)))
+      ++code_end;
+    if(code_end == pos + 1)
+      return false;
+    pos = code_end;
+  }
+
+  if(!starts_with(line, pos, ":"))
+    return false;
+  ++pos;
+  if(starts_with(line, pos, " "))
+    ++pos;
+  diagnostic.message = line.substr(pos);
+  return true;
+}
+
+bool BuildDiagnostics::starts_with(const std::string &line, size_t pos, const char *str) {
+  return pos <= line.size() && line.compare(pos, std::strlen(str), str) == 0;
+}
+
+bool BuildDiagnostics::is_digit(const std::string &line, size_t pos) {
+  return pos < line.size() && line[pos] >= '0' && line[pos] <= '9';
+}
+
+bool BuildDiagnostics::parse_number(const std::string &line, size_t &pos, unsigned long &number) {
+  if(!is_digit(line, pos))
+    return false;
+  number = 0;
+  while(is_digit(line, pos))
+    number = number * 10 + static_cast<unsigned long>(line[pos++] - '0');
+  return true;
+}
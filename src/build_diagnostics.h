@@ -0,0 +1,59 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// Errors and warnings, with their notes, parsed from build output one line at a time as it is printed.
+/// Supports the GCC/Clang, MSVC and Rust diagnostic formats.
+class BuildDiagnostics {
+public:
+  class Diagnostic {
+  public:
+    enum class Severity { NOTE, WARNING, ERROR };
+
+    std::string path;
+    /// 1-based
+    unsigned long line;
+    /// 1-based, or 1 if the column was not given
+    unsigned long line_offset;
+    Severity severity;
+    std::string message;
+    /// Notes that followed the error or warning
+    std::vector<Diagnostic> notes;
+  };
+
+  /// Parses a line of build output, without line ending.
+  /// Returns the error or warning that the line added, valid until the next call, or nullptr if none was added.
+  Diagnostic *add_line(const std::string &line);
+
+  void clear();
+
+  /// Returns the next error or warning after the current one, starting over after the last one, or nullptr if there are none
+  const Diagnostic *next();
+  /// Returns the previous error or warning before the current one, starting over before the first one, or nullptr if there are none
+  const Diagnostic *previous();
+  /// Index of the diagnostic last returned by next() or previous(), or -1 if none
+  size_t get_current() const { return current; }
+
+  std::vector<Diagnostic> diagnostics;
+  /// Resolved paths of the diagnostics by the path given in the build output, so that each path is only resolved once
+  std::unordered_map<std::string, std::string> resolved_paths;
+
+private:
+  size_t current = -1;
+  /// A Rust error or warning, whose location is given in the next line
+  std::unique_ptr<Diagnostic> rust_diagnostic;
+
+  /// Parses path:line:column: severity: message, where the column is optional
+  static bool parse_gcc(const std::string &line, Diagnostic &diagnostic);
+  /// Parses path(line,column): severity code: message, where the column is optional
+  static bool parse_msvc(const std::string &line, Diagnostic &diagnostic);
+  /// Parses severity, an optional [code], and : message. Returns false if line does not start with a severity.
+  static bool parse_severity(const std::string &line, size_t pos, Diagnostic &diagnostic);
+
+  static bool starts_with(const std::string &line, size_t pos, const char *str);
+  static bool is_digit(const std::string &line, size_t pos);
+  /// Parses the digits at pos, and moves pos past them. Returns false if there are no digits at pos.
+  static bool parse_number(const std::string &line, size_t &pos, unsigned long &number);
+};
@@ -121,9 +121,9 @@ boost::filesystem::path CMake::get_executable(const boost::filesystem::path &bui
   }
 
 
-  CompileCommands compile_commands(build_path);
+  auto compile_commands = CompileCommands::get(build_path);
   std::vector<std::pair<boost::filesystem::path, boost::filesystem::path>> command_files_and_maybe_executables;
-  for(auto &command : compile_commands.commands) {
+  for(auto &command : compile_commands->commands) {
     auto command_file = filesystem::get_normal_path(command.file);
     auto values = command.parameter_values("-o");
     if(!values.empty()) {
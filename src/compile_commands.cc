@@ -1,9 +1,13 @@
 #include "compile_commands.h"
 #include "clangmm.h"
+#include "filesystem.h"
 #include <algorithm>
 #include <boost/property_tree/json_parser.hpp>
 #include <regex>
 
+Mutex CompileCommands::caches_mutex;
+std::map<boost::filesystem::path, CompileCommands::Cache> CompileCommands::caches;
+
 std::vector<std::string> CompileCommands::Command::parameter_values(const std::string &parameter_name) const {
   std::vector<std::string> parameter_values;
 
@@ -80,6 +84,50 @@ CompileCommands::CompileCommands(const boost::filesystem::path &build_path) {
   }
   catch(...) {
   }
+
+  for(size_t c = 0; c < commands.size(); ++c) {
+    auto file = filesystem::get_normal_path(commands[c].file);
+    auto &indices = file_commands[file.string()];
+    if(indices.empty())
+      directory_files[file.parent_path().string()].emplace_back(file);
+    indices.emplace_back(c);
+  }
+}
+
+std::shared_ptr<const CompileCommands> CompileCommands::get(const boost::filesystem::path &build_path) {
+  LockGuard lock(caches_mutex);
+  auto &cache = get_cache(build_path);
+  if(!cache.compile_commands)
+    cache.compile_commands = std::make_shared<CompileCommands>(build_path);
+  return cache.compile_commands;
+}
+
+CompileCommands::Cache &CompileCommands::get_cache(const boost::filesystem::path &build_path) {
+  boost::system::error_code ec;
+  auto last_write_time = boost::filesystem::last_write_time(build_path / "compile_commands.json", ec);
+  auto &cache = caches[build_path];
+  if(ec || cache.last_write_time == 0 || cache.last_write_time != last_write_time) {
+    cache.compile_commands.reset();
+    cache.database.reset();
+    cache.last_write_time = !ec ? filesystem::get_stable_last_write_time(last_write_time) : 0;
+  }
+  return cache;
+}
+
+std::vector<const CompileCommands::Command *> CompileCommands::get_commands(const boost::filesystem::path &file_path) const {
+  std::vector<const Command *> result;
+  auto it = file_commands.find(filesystem::get_normal_path(file_path).string());
+  if(it != file_commands.end()) {
+    for(auto index : it->second)
+      result.emplace_back(&commands[index]);
+  }
+  return result;
+}
+
+const std::vector<boost::filesystem::path> &CompileCommands::get_files(const boost::filesystem::path &directory) const {
+  const static std::vector<boost::filesystem::path> empty;
+  auto it = directory_files.find(filesystem::get_normal_path(directory).string());
+  return it != directory_files.end() ? it->second : empty;
 }
 
 std::vector<std::string> CompileCommands::get_arguments(const boost::filesystem::path &build_path, const boost::filesystem::path &file_path) {
@@ -90,21 +138,20 @@ std::vector<std::string> CompileCommands::get_arguments(const boost::filesystem:
 
   // If header file, use source file flags if they are in the same folder
   std::vector<boost::filesystem::path> file_paths;
-  if(is_header && !extension.empty()) {
-    auto parent_path = file_path.parent_path();
-    CompileCommands compile_commands(build_path);
-    for(auto &command : compile_commands.commands) {
-      if(command.file.parent_path() == parent_path)
-        file_paths.emplace_back(command.file);
-    }
-  }
+  if(is_header && !extension.empty())
+    file_paths = get(build_path)->get_files(file_path.parent_path());
 
   if(file_paths.empty())
     file_paths.emplace_back(file_path);
 
   std::vector<std::string> arguments;
   if(!build_path.empty()) {
-    clangmm::CompilationDatabase db(build_path.string());
+    // The database is shared, and only used while caches_mutex is locked
+    LockGuard lock(caches_mutex);
+    auto &cache = get_cache(build_path);
+    if(!cache.database)
+      cache.database = std::make_shared<clangmm::CompilationDatabase>(build_path.string());
+    auto &db = *cache.database;
     if(db) {
       for(auto &file_path : file_paths) {
         clangmm::CompileCommands compile_commands(file_path.string(), db);
@@ -1,8 +1,17 @@
 #pragma once
+#include "mutex.h"
 #include <boost/filesystem.hpp>
+#include <ctime>
+#include <map>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+namespace clangmm {
+  class CompilationDatabase;
+}
+
 class CompileCommands {
 public:
   class Command {
@@ -17,9 +26,38 @@ public:
   CompileCommands(const boost::filesystem::path &build_path);
   std::vector<Command> commands;
 
+  /// Returns the compile commands of build_path, shared by all callers.
+  /// compile_commands.json is only read again if its last write time has changed.
+  static std::shared_ptr<const CompileCommands> get(const boost::filesystem::path &build_path);
+
+  /// Returns the commands of the given file
+  std::vector<const Command *> get_commands(const boost::filesystem::path &file_path) const;
+  /// Returns the files, with normalized paths, that have commands and are directly in the given directory
+  const std::vector<boost::filesystem::path> &get_files(const boost::filesystem::path &directory) const;
+
   /// Return arguments for the given file using libclangmm
   static std::vector<std::string> get_arguments(const boost::filesystem::path &build_path, const boost::filesystem::path &file_path);
 
   static bool is_header(const boost::filesystem::path &path);
   static bool is_source(const boost::filesystem::path &path);
+
+private:
+  /// Indices of commands by normalized file path
+  std::unordered_map<std::string, std::vector<size_t>> file_commands;
+  /// Normalized file paths by their parent directory
+  std::unordered_map<std::string, std::vector<boost::filesystem::path>> directory_files;
+
+  class Cache {
+  public:
+    /// Last write time of compile_commands.json, 0 if it should be read again on next use
+    std::time_t last_write_time = 0;
+    std::shared_ptr<const CompileCommands> compile_commands;
+    std::shared_ptr<clangmm::CompilationDatabase> database;
+  };
+
+  static Mutex caches_mutex;
+  static std::map<boost::filesystem::path, Cache> caches GUARDED_BY(caches_mutex);
+
+  /// Returns the cache of build_path, cleared if compile_commands.json has changed
+  static Cache &get_cache(const boost::filesystem::path &build_path) REQUIRES(caches_mutex);
 };
@@ -175,6 +175,7 @@ void Config::read(const boost::property_tree::ptree &cfg) {
   source.auto_reload_changed_files = source_json.get<bool>("auto_reload_changed_files");
   source.clang_format_style = source_json.get<std::string>("clang_format_style");
   source.clang_usages_threads = static_cast<unsigned>(source_json.get<int>("clang_usages_threads"));
+  source.restored_tabs_parsed_at_startup = source_json.get<int>("restored_tabs_parsed_at_startup");
   auto pt_doc_search = cfg.get_child("documentation_searches");
   for(auto &pt_doc_search_lang : pt_doc_search) {
     source.documentation_searches[pt_doc_search_lang.first].separator = pt_doc_search_lang.second.get<std::string>("separator");
@@ -200,6 +201,7 @@ void Config::read(const boost::property_tree::ptree &cfg) {
   project.save_on_compile_or_run = cfg.get<bool>("project.save_on_compile_or_run");
   project.clear_terminal_on_compile = cfg.get<bool>("project.clear_terminal_on_compile");
   project.ctags_command = cfg.get<std::string>("project.ctags_command");
+  project.trigram_index = cfg.get<bool>("project.trigram_index");
   project.python_command = cfg.get<std::string>("project.python_command");
 
   terminal.history_size = cfg.get<int>("terminal.history_size");
@@ -48,6 +48,7 @@ public:
     bool save_on_compile_or_run;
     bool clear_terminal_on_compile;
     std::string ctags_command;
+    bool trigram_index;
     std::string python_command;
   };
 
@@ -91,6 +92,7 @@ public:
 
     std::string clang_format_style;
     unsigned clang_usages_threads;
+    int restored_tabs_parsed_at_startup;
 
     std::unordered_map<std::string, DocumentationSearch> documentation_searches;
   };
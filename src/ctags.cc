@@ -1,20 +1,44 @@
 #include "ctags.h"
 #include "config.h"
-#include "filesystem.h"
 #include "project_build.h"
+#include "project_files.h"
 #include "terminal.h"
+#include <algorithm>
+#include <cctype>
 #include <climits>
+#include <fstream>
 #include <iostream>
-#include <regex>
+#include <set>
+#include <sstream>
+#include <thread>
 #include <vector>
 
-std::pair<boost::filesystem::path, std::unique_ptr<std::stringstream>> Ctags::get_result(const boost::filesystem::path &path) {
+Mutex Ctags::indices_mutex;
+std::map<boost::filesystem::path, Ctags::Index> Ctags::indices;
+std::map<boost::filesystem::path, boost::filesystem::path> Ctags::run_paths;
+
+std::pair<boost::filesystem::path, std::shared_ptr<const std::vector<std::string>>> Ctags::get_result(const boost::filesystem::path &path) {
+  Index *index;
+  {
+    LockGuard lock(indices_mutex);
+    index = &get_index(path);
+  }
+  update(*index);
+  LockGuard lock(indices_mutex);
+  return {index->run_path, index->lines};
+}
+
+Ctags::Index &Ctags::get_index(const boost::filesystem::path &path) {
+  auto run_path_it = run_paths.find(path);
+  if(run_path_it != run_paths.end())
+    return indices[run_path_it->second];
+
   auto build = Project::Build::create(path);
   auto run_path = build->project_path;
-  std::string exclude = " --exclude=node_modules";
+  boost::filesystem::path build_path, debug_path;
   if(!run_path.empty()) {
-    exclude += " --exclude=" + filesystem::get_relative_path(build->get_default_path(), run_path).string();
-    exclude += " --exclude=" + filesystem::get_relative_path(build->get_debug_path(), run_path).string();
+    build_path = build->get_default_path();
+    debug_path = build->get_debug_path();
   }
   else {
     boost::system::error_code ec;
@@ -23,48 +47,299 @@ std::pair<boost::filesystem::path, std::unique_ptr<std::stringstream>> Ctags::ge
     else
       run_path = path.parent_path();
   }
+  run_paths.emplace(path, run_path);
 
-  std::stringstream stdin_stream;
-  //TODO: when debian stable gets newer g++ version that supports move on streams, remove unique_ptr below
-  auto stdout_stream = std::make_unique<std::stringstream>();
-  auto command = Config::get().project.ctags_command + exclude + " --fields=ns --sort=foldcase -I \"override noexcept\" -f - -R *";
-  Terminal::get().process(stdin_stream, *stdout_stream, command, run_path);
-  return {run_path, std::move(stdout_stream)};
+  auto &index = indices[run_path];
+  if(index.run_path.empty()) {
+    index.run_path = run_path;
+    index.build_path = build_path;
+    index.debug_path = debug_path;
+    if(!build_path.empty())
+      index.tags_path = build_path / ".juci_tags";
+  }
+  return index;
 }
 
-Ctags::Location Ctags::get_location(const std::string &line, bool markup) {
-  Location location;
+void Ctags::update(Index &index) {
+  LockGuard lock(index.update_mutex);
+  if(!index.tags_read) {
+    index.tags_read = true;
+    read_tags(index);
+  }
+  auto &run_path = index.run_path;
+
+  // Find new and changed files
+  std::vector<std::string> changed_paths;
+  std::set<std::string> paths;
+  auto files = ProjectFiles::get_files(run_path, index.build_path, index.debug_path);
+  for(auto &relative_path : *files) {
+    // Skip hidden files and directories, and node_modules
+    bool skip = false;
+    size_t pos = 0;
+    while(true) {
+      if(relative_path[pos] == '.' || relative_path.compare(pos, 13, "node_modules/") == 0) {
+        skip = true;
+        break;
+      }
+      pos = relative_path.find('/', pos);
+      if(pos == std::string::npos)
+        break;
+      ++pos;
+    }
+    if(skip)
+      continue;
+    boost::system::error_code ec;
+    auto last_write_time = boost::filesystem::last_write_time(run_path / relative_path, ec);
+    if(ec)
+      continue;
+    paths.emplace(relative_path);
+    auto file_it = index.files.find(relative_path);
+    if(file_it == index.files.end() || file_it->second.last_write_time != last_write_time) {
+      index.files[relative_path] = File{last_write_time, {}};
+      changed_paths.emplace_back(relative_path);
+    }
+  }
+
+  // Remove deleted files
+  bool files_removed = false;
+  for(auto it = index.files.begin(); it != index.files.end();) {
+    if(paths.count(it->first) == 0) {
+      it = index.files.erase(it);
+      files_removed = true;
+    }
+    else
+      ++it;
+  }
+
+  if(!changed_paths.empty()) {
+    std::stringstream stdin_stream;
+    for(auto &changed_path : changed_paths)
+      stdin_stream << changed_path << '\n';
+    std::stringstream stdout_stream;
+    auto command = Config::get().project.ctags_command + " --fields=ns --sort=no -I \"override noexcept\" -f - -L -";
+    if(Terminal::get().process(stdin_stream, stdout_stream, command, run_path) == 0) {
+      std::string line;
+      while(std::getline(stdout_stream, line)) {
+        auto pos = line.find('\t');
+        if(pos == std::string::npos)
+          continue;
+        auto end_pos = line.find('\t', pos + 1);
+        if(end_pos == std::string::npos)
+          continue;
+        auto file_it = index.files.find(line.substr(pos + 1, end_pos - pos - 1));
+        if(file_it != index.files.end())
+          file_it->second.lines.emplace_back(std::move(line));
+      }
+    }
+    else {
+      // Parse the changed files again on next call
+      for(auto &changed_path : changed_paths)
+        index.files.erase(changed_path);
+      changed_paths.clear();
+    }
+  }
+
+  bool lines_missing;
+  {
+    LockGuard indices_lock(indices_mutex);
+    lines_missing = !index.lines;
+  }
+  if(!changed_paths.empty() || files_removed || lines_missing) {
+    auto lines = std::make_shared<std::vector<std::string>>();
+    for(auto &file : index.files)
+      lines->insert(lines->end(), file.second.lines.begin(), file.second.lines.end());
+    std::sort(lines->begin(), lines->end(), [](const std::string &lhs, const std::string &rhs) {
+      return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), [](char lhs, char rhs) {
+        return std::tolower(static_cast<unsigned char>(lhs)) < std::tolower(static_cast<unsigned char>(rhs));
+      });
+    });
+    auto names = std::make_shared<std::unordered_map<std::string, std::vector<size_t>>>();
+    LineFields fields;
+    for(size_t c = 0; c < lines->size(); ++c) {
+      auto &line = (*lines)[c];
+      if(parse_line(line, fields)) {
+        auto name = get_symbol(line);
+        if(fields.scope.second > fields.scope.first)
+          name.insert(0, line.substr(fields.scope.first, fields.scope.second - fields.scope.first) + "::");
+        (*names)[name].emplace_back(c);
+      }
+    }
+    {
+      LockGuard indices_lock(indices_mutex);
+      index.lines = std::move(lines);
+      index.names = std::move(names);
+    }
+
+    if(!changed_paths.empty() || files_removed)
+      write_tags(index);
+  }
+}
+
+void Ctags::read_tags(Index &index) {
+  std::ifstream stream(index.tags_path.string());
+  if(!stream)
+    return;
+  static const std::string file_prefix = "!_JUCI_FILE\t";
+  File *file = nullptr;
+  std::string line;
+  while(std::getline(stream, line)) {
+    if(line.compare(0, file_prefix.size(), file_prefix) == 0) {
+      file = nullptr;
+      auto pos = line.find('\t', file_prefix.size());
+      if(pos == std::string::npos)
+        continue;
+      std::time_t last_write_time;
+      try {
+        last_write_time = std::stoll(line.substr(pos + 1));
+      }
+      catch(const std::exception &) {
+        continue;
+      }
+      file = &index.files[line.substr(file_prefix.size(), pos - file_prefix.size())];
+      file->last_write_time = last_write_time;
+      file->lines.clear();
+    }
+    else if(file)
+      file->lines.emplace_back(std::move(line));
+  }
+}
 
+void Ctags::write_tags(const Index &index) {
+  boost::system::error_code ec;
+  if(index.tags_path.empty() || !boost::filesystem::is_directory(index.tags_path.parent_path(), ec))
+    return;
+  std::ofstream stream(index.tags_path.string());
+  if(stream) {
+    for(auto &file : index.files) {
+      stream << "!_JUCI_FILE\t" << file.first << '\t' << file.second.last_write_time << '\n';
+      for(auto &line : file.second.lines)
+        stream << line << '\n';
+    }
+  }
+}
+
+std::string Ctags::get_symbol(const std::string &line) {
+  auto symbol = line.substr(0, line.find('\t'));
+  //fix symbol for operators
+  if(9 < symbol.size() && symbol[8] == ' ' && symbol.compare(0, 8, "operator") == 0) {
+    auto &chr = symbol[9];
+    if(!((chr >= 'a' && chr <= 'z') || (chr >= 'A' && chr <= 'Z') || (chr >= '0' && chr <= '9') || chr == '_'))
+      symbol.erase(8, 1);
+  }
+  return symbol;
+}
+
+bool Ctags::parse_line(const std::string &line, LineFields &fields) {
+  auto size = line.size();
 #ifdef _WIN32
-  auto line_fixed = line;
-  if(!line_fixed.empty() && line_fixed.back() == '\r')
-    line_fixed.pop_back();
-#else
-  auto &line_fixed = line;
+  if(size > 0 && line[size - 1] == '\r')
+    --size;
 #endif
 
-  const static std::regex regex(R"(^([^\t]+)\t([^\t]+)\t(?:/\^)?([ \t]*)(.+?)(\$/)?;"\tline:([0-9]+)\t?[a-zA-Z]*:?(.*)$)");
-  std::smatch sm;
-  if(std::regex_match(line_fixed, sm, regex)) {
-    location.symbol = sm[1].str();
-    //fix location.symbol for operators
-    if(9 < location.symbol.size() && location.symbol[8] == ' ' && location.symbol.compare(0, 8, "operator") == 0) {
-      auto &chr = location.symbol[9];
-      if(!((chr >= 'a' && chr <= 'z') || (chr >= 'A' && chr <= 'Z') || (chr >= '0' && chr <= '9') || chr == '_'))
-        location.symbol.erase(8, 1);
+  // Parses lines in the same way as the following regular expression:
+  // ^([^\t]+)\t([^\t]+)\t(?:/\^)?([ \t]*)(.+?)(\$/)?;"\tline:([0-9]+)\t?[a-zA-Z]*:?(.*)$
+  auto is_line_terminator = [](char chr) {
+    return chr == '\n' || chr == '\r';
+  };
+  auto is_digit = [](char chr) {
+    return chr >= '0' && chr <= '9';
+  };
+
+  size_t pos = 0;
+  while(pos < size && line[pos] != '\t')
+    ++pos;
+  if(pos == 0 || pos == size)
+    return false;
+  fields.symbol = {0, pos};
+
+  auto file_start = ++pos;
+  while(pos < size && line[pos] != '\t')
+    ++pos;
+  if(pos == file_start || pos == size)
+    return false;
+  fields.file = {file_start, pos};
+  ++pos;
+
+  // Returns the position of the line number if the end of the source is at source_end
+  static const char line_field[] = ";\"\tline:";
+  const size_t line_field_size = sizeof(line_field) - 1;
+  auto get_line_start = [&](size_t source_end, bool &pattern_end) -> size_t {
+    auto pos = source_end;
+    pattern_end = pos + 2 <= size && line[pos] == '$' && line[pos + 1] == '/';
+    if(pattern_end)
+      pos += 2;
+    if(pos + line_field_size >= size || line.compare(pos, line_field_size, line_field) != 0)
+      return std::string::npos;
+    pos += line_field_size;
+    if(!is_digit(line[pos]))
+      return std::string::npos;
+    for(auto c = pos; c < size; ++c) {
+      if(is_line_terminator(line[c]))
+        return std::string::npos;
     }
+    return pos;
+  };
 
-    location.file_path = sm[2].str();
-    location.source = sm[4].str();
-    try {
-      location.line = std::stoul(sm[6]) - 1;
+  bool pattern_start = pos + 2 <= size && line[pos] == '/' && line[pos + 1] == '^';
+  for(int skip_pattern_start = pattern_start ? 1 : 0; skip_pattern_start >= 0; --skip_pattern_start) {
+    auto indentation_start = pos + 2 * skip_pattern_start;
+    auto indentation_end = indentation_start;
+    while(indentation_end < size && (line[indentation_end] == ' ' || line[indentation_end] == '\t'))
+      ++indentation_end;
+    for(auto source_start = indentation_end;; --source_start) {
+      for(auto source_end = source_start + 1; source_end <= size; ++source_end) {
+        if(is_line_terminator(line[source_end - 1]))
+          break;
+        bool pattern_end;
+        auto line_start = get_line_start(source_end, pattern_end);
+        if(line_start != std::string::npos) {
+          fields.indentation = {indentation_start, source_start};
+          fields.source = {source_start, source_end};
+          fields.pattern_end = pattern_end;
+          auto line_end = line_start;
+          while(line_end < size && is_digit(line[line_end]))
+            ++line_end;
+          fields.line = {line_start, line_end};
+          auto scope_start = line_end;
+          if(scope_start < size && line[scope_start] == '\t')
+            ++scope_start;
+          while(scope_start < size && ((line[scope_start] >= 'a' && line[scope_start] <= 'z') || (line[scope_start] >= 'A' && line[scope_start] <= 'Z')))
+            ++scope_start;
+          if(scope_start < size && line[scope_start] == ':')
+            ++scope_start;
+          fields.scope = {scope_start, size};
+          return true;
+        }
+      }
+      if(source_start == indentation_start)
+        break;
     }
-    catch(const std::exception &) {
-      location.line = 0;
+  }
+  return false;
+}
+
+Ctags::Location Ctags::get_location(const std::string &line, bool markup) {
+  Location location;
+
+  LineFields fields;
+  if(parse_line(line, fields)) {
+    location.symbol = get_symbol(line);
+
+    location.file_path = line.substr(fields.file.first, fields.file.second - fields.file.first);
+    location.source = line.substr(fields.source.first, fields.source.second - fields.source.first);
+    unsigned long line_number = 0;
+    for(auto c = fields.line.first; c < fields.line.second; ++c) {
+      unsigned long digit = line[c] - '0';
+      if(line_number > (ULONG_MAX - digit) / 10) { // Out of range
+        line_number = 1;
+        break;
+      }
+      line_number = line_number * 10 + digit;
     }
-    location.scope = sm[7].str();
-    if(!sm[5].str().empty()) {
-      location.index = sm[3].str().size();
+    location.line = line_number - 1;
+    location.scope = line.substr(fields.scope.first, fields.scope.second - fields.scope.first);
+    if(fields.pattern_end) {
+      location.index = fields.indentation.second - fields.indentation.first;
 
       size_t pos = location.source.find(location.symbol);
       if(pos != std::string::npos)
@@ -117,11 +392,34 @@ std::vector<std::string> Ctags::get_type_parts(const std::string &type) {
 }
 
 std::vector<Ctags::Location> Ctags::get_locations(const boost::filesystem::path &path, const std::string &name, const std::string &type) {
-  auto result = get_result(path);
-  result.second->seekg(0, std::ios::end);
-  if(result.second->tellg() == 0)
+  Index *index;
+  std::shared_ptr<const std::vector<std::string>> lines;
+  std::shared_ptr<const std::unordered_map<std::string, std::vector<size_t>>> names;
+  {
+    LockGuard lock(indices_mutex);
+    index = &get_index(path);
+    lines = index->lines;
+    names = index->names;
+    // The existing index is used, since this is called from the main thread, and it is updated in the background for later lookups
+    if(lines && !index->updating) {
+      index->updating = true;
+      std::thread([index] {
+        update(*index);
+        LockGuard lock(indices_mutex);
+        index->updating = false;
+      }).detach();
+    }
+  }
+  if(!lines) { // The index is built on first use
+    update(*index);
+    LockGuard lock(indices_mutex);
+    lines = index->lines;
+    names = index->names;
+  }
+
+  auto name_it = names->find(name);
+  if(name_it == names->end())
     return std::vector<Location>();
-  result.second->seekg(0, std::ios::beg);
 
   //insert name into type
   size_t c = 0;
@@ -139,21 +437,14 @@ std::vector<Ctags::Location> Ctags::get_locations(const boost::filesystem::path
 
   auto parts = get_type_parts(full_type);
 
-  std::string line;
   long best_score = LONG_MIN;
   std::vector<Location> best_locations;
-  while(std::getline(*result.second, line)) {
+  for(auto line_index : name_it->second) {
+    auto &line = (*lines)[line_index];
     if(line.size() > 2048)
       continue;
     auto location = Ctags::get_location(line, false);
-    if(!location.scope.empty()) {
-      if(location.scope + "::" + location.symbol != name)
-        continue;
-    }
-    else if(location.symbol != name)
-      continue;
-
-    location.file_path = result.first / location.file_path;
+    location.file_path = index->run_path / location.file_path;
 
     auto source_parts = get_type_parts(location.source);
 
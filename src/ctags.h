@@ -1,7 +1,11 @@
 #pragma once
+#include "mutex.h"
 #include <boost/filesystem.hpp>
-#include <sstream>
+#include <ctime>
+#include <map>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 class Ctags {
@@ -17,12 +21,60 @@ public:
     operator bool() const { return !file_path.empty(); }
   };
 
-  static std::pair<boost::filesystem::path, std::unique_ptr<std::stringstream>> get_result(const boost::filesystem::path &path);
+  /// Returns the path that the tag file paths are relative to, and the tag lines sorted case-insensitively.
+  /// The tags are kept in memory, and in the build directory if any, and only files that have changed are parsed again.
+  static std::pair<boost::filesystem::path, std::shared_ptr<const std::vector<std::string>>> get_result(const boost::filesystem::path &path);
 
   static Location get_location(const std::string &line, bool markup);
 
   static std::vector<Location> get_locations(const boost::filesystem::path &path, const std::string &name, const std::string &type);
 
 private:
+  class File {
+  public:
+    std::time_t last_write_time;
+    std::vector<std::string> lines;
+  };
+
+  class Index {
+  public:
+    boost::filesystem::path run_path, build_path, debug_path;
+    /// Tag file in the build directory, empty if the project has no build directory
+    boost::filesystem::path tags_path;
+    /// Held while the index is updated, so that ctags runs without holding indices_mutex
+    Mutex update_mutex;
+    bool tags_read GUARDED_BY(update_mutex) = false;
+    /// Tags by file path relative to run_path
+    std::map<std::string, File> files GUARDED_BY(update_mutex);
+    /// All tag lines sorted case-insensitively, replaced when files change. Only used while holding indices_mutex.
+    std::shared_ptr<const std::vector<std::string>> lines;
+    /// Indices of lines by qualified name, that is scope::symbol or symbol. Only used while holding indices_mutex.
+    std::shared_ptr<const std::unordered_map<std::string, std::vector<size_t>>> names;
+    /// True while the index is updated in a background thread. Only used while holding indices_mutex.
+    bool updating = false;
+  };
+
+  static Mutex indices_mutex;
+  static std::map<boost::filesystem::path, Index> indices GUARDED_BY(indices_mutex);
+  /// Project path of the paths passed to get_index, so that the project is only looked up once per path
+  static std::map<boost::filesystem::path, boost::filesystem::path> run_paths GUARDED_BY(indices_mutex);
+
+  /// Returns the index for the project containing path, without updating it
+  static Index &get_index(const boost::filesystem::path &path) REQUIRES(indices_mutex);
+  /// Parses new and changed files, and replaces the lines and names of the index if files have changed
+  static void update(Index &index) EXCLUDES(indices_mutex);
+  static void read_tags(Index &index) REQUIRES(index.update_mutex);
+  static void write_tags(const Index &index) REQUIRES(index.update_mutex);
+  static std::string get_symbol(const std::string &line);
+
+  /// Positions of the fields in a line of ctags output, as [first, second)
+  class LineFields {
+  public:
+    std::pair<size_t, size_t> symbol, file, indentation, source, line, scope;
+    /// True if the source is a complete line pattern (ends with $/)
+    bool pattern_end;
+  };
+  /// Parses a line of ctags output with the fields n and s, without allocating
+  static bool parse_line(const std::string &line, LineFields &fields);
   static std::vector<std::string> get_type_parts(const std::string &type);
 };
@@ -120,129 +120,6 @@ Directories::Directories() : Gtk::ListViewText(1) {
 
   get_style_context()->add_class("juci_directories");
 
-  tree_store->set_sort_column(column_record.name, Gtk::SortType::SORT_ASCENDING);
-  tree_store->set_sort_func(column_record.name, [this](const Gtk::TreeModel::iterator &it1, const Gtk::TreeModel::iterator &it2) {
-    /// Natural comparison supporting UTF-8 and locale
-    struct Natural {
-      static bool is_digit(char chr) {
-        return chr >= '0' && chr <= '9';
-      }
-
-      static int compare_characters(size_t &i1, size_t &i2, const std::string &s1, const std::string &s2) {
-        ScopeGuard scope_guard{[&i1, &i2] {
-          ++i1;
-          ++i2;
-        }};
-        auto c1 = static_cast<unsigned char>(s1[i1]);
-        auto c2 = static_cast<unsigned char>(s2[i2]);
-        if(c1 < 0b10000000 && c2 < 0b10000000) { // Both characters are ascii
-          auto at = std::tolower(s1[i1]);
-          auto bt = std::tolower(s2[i2]);
-          if(at < bt)
-            return -1;
-          else if(at == bt)
-            return 0;
-          else
-            return 1;
-        }
-
-        Glib::ustring u1;
-        if(c1 >= 0b11110000)
-          u1 = s1.substr(i1, 4);
-        else if(c1 >= 0b11100000)
-          u1 = s1.substr(i1, 3);
-        else if(c1 >= 0b11000000)
-          u1 = s1.substr(i1, 2);
-        else
-          u1 = s1[i1];
-
-        Glib::ustring u2;
-        if(c2 >= 0b11110000)
-          u2 = s2.substr(i2, 4);
-        else if(c2 >= 0b11100000)
-          u2 = s2.substr(i2, 3);
-        else if(c2 >= 0b11000000)
-          u2 = s2.substr(i2, 2);
-        else
-          u2 = s2[i2];
-
-        i1 += u1.bytes() - 1;
-        i2 += u2.bytes() - 1;
-
-        u1 = u1.lowercase();
-        u2 = u2.lowercase();
-
-        if(u1 < u2)
-          return -1;
-        else if(u1 == u2)
-          return 0;
-        else
-          return 1;
-      }
-
-      static int compare_numbers(size_t &i1, size_t &i2, const std::string &s1, const std::string &s2) {
-        int result = 0;
-        while(true) {
-          if(i1 >= s1.size() || !is_digit(s1[i1])) {
-            if(i2 >= s2.size() || !is_digit(s2[i2])) // a and b has equal number of digits
-              return result;
-            return -1; // a has fewer digits
-          }
-          if(i2 >= s2.size() || !is_digit(s2[i2]))
-            return 1; // b has fewer digits
-
-          if(result == 0) {
-            if(s1[i1] < s2[i2])
-              result = -1;
-            if(s1[i1] > s2[i2])
-              result = 1;
-          }
-          ++i1;
-          ++i2;
-        }
-      }
-
-      static int compare(const std::string &s1, const std::string &s2) {
-        size_t i1 = 0;
-        size_t i2 = 0;
-        while(i1 < s1.size() && i2 < s2.size()) {
-          if(is_digit(s1[i1]) && !is_digit(s2[i2]))
-            return -1;
-          if(!is_digit(s1[i1]) && is_digit(s2[i2]))
-            return 1;
-          if(!is_digit(s1[i1]) && !is_digit(s2[i2])) {
-            auto result = compare_characters(i1, i2, s1, s2);
-            if(result != 0)
-              return result;
-          }
-          else {
-            auto result = compare_numbers(i1, i2, s1, s2);
-            if(result != 0)
-              return result;
-          }
-        }
-        if(i1 >= s1.size())
-          return -1;
-        return 1;
-      }
-    };
-
-    auto name1 = it1->get_value(column_record.name);
-    auto name2 = it2->get_value(column_record.name);
-    if(name1.empty())
-      return -1;
-    if(name2.empty())
-      return 1;
-
-    std::string prefix1, prefix2;
-    prefix1 += it1->get_value(column_record.is_directory) ? 'a' : 'b';
-    prefix2 += it2->get_value(column_record.is_directory) ? 'a' : 'b';
-    prefix1 += name1[0] == '.' ? 'a' : 'b';
-    prefix2 += name2[0] == '.' ? 'a' : 'b';
-
-    return Natural::compare(prefix1 + name1, prefix2 + name2);
-  });
-
   set_enable_search(true); //TODO: why does this not work in OS X?
   set_search_column(column_record.name);
 
@@ -483,9 +360,18 @@ Directories::Directories() : Gtk::ListViewText(1) {
       });
     }
   });
+
+  // Changes that the directory monitors do not report, for instance in collapsed directories,
+  // are found when the repositories read their whole status again
+  colorize_connection = Glib::signal_timeout().connect_seconds([this] {
+    for(auto &directory : directories)
+      colorize_path(directory.first, false);
+    return true;
+  }, 30);
 }
 
 Directories::~Directories() {
+  colorize_connection.disconnect();
   dispatcher.disconnect();
 }
 
@@ -528,7 +414,7 @@ void Directories::on_save_file(const boost::filesystem::path &file_path) {
   auto it = directories.find(file_path.parent_path().string());
   if(it != directories.end()) {
     if(it->second.repository)
-      it->second.repository->clear_saved_status();
+      it->second.repository->clear_saved_status(file_path);
     colorize_path(it->first, true);
   }
 }
@@ -547,16 +433,13 @@ void Directories::select(const boost::filesystem::path &select_path) {
       return;
   }
 
-  std::list<boost::filesystem::path> paths;
   boost::filesystem::path parent_path;
   if(boost::filesystem::is_directory(select_path))
     parent_path = select_path;
   else
     parent_path = select_path.parent_path();
 
-  //check if select_path is already expanded
-  if(directories.find(parent_path.string()) != directories.end()) {
-    //set cursor at select_path and return
+  auto set_cursor_at_select_path = [this, select_path] {
     tree_store->foreach_iter([this, &select_path](const Gtk::TreeModel::iterator &iter) {
       if(iter->get_value(column_record.path) == select_path) {
         auto tree_path = Gtk::TreePath(iter);
@@ -566,32 +449,50 @@ void Directories::select(const boost::filesystem::path &select_path) {
       }
       return false;
     });
+  };
+
+  //check if select_path is already expanded
+  auto it = directories.find(parent_path.string());
+  if(it != directories.end()) {
+    if(it->second.updating)
+      it->second.on_updated.emplace_back(set_cursor_at_select_path);
+    else
+      set_cursor_at_select_path();
     return;
   }
 
-  paths.emplace_front(parent_path);
+  std::vector<boost::filesystem::path> paths;
+  paths.emplace_back(parent_path);
   while(parent_path != path) {
     parent_path = parent_path.parent_path();
-    paths.emplace_front(parent_path);
+    paths.emplace_back(parent_path);
   }
+  expand_paths(std::move(paths), set_cursor_at_select_path);
+}
 
-  //expand to select_path
-  for(auto &a_path : paths) {
-    tree_store->foreach_iter([this, &a_path](const Gtk::TreeModel::iterator &iter) {
-      if(iter->get_value(column_record.path) == a_path) {
-        add_or_update_path(a_path, *iter, true);
-        return true;
-      }
-      return false;
-    });
+void Directories::expand_paths(std::vector<boost::filesystem::path> paths, std::function<void()> on_expanded) {
+  if(paths.empty()) {
+    on_expanded();
+    return;
+  }
+  auto dir_path = std::move(paths.back());
+  paths.pop_back();
+  auto expand_next = [this, paths = std::move(paths), on_expanded = std::move(on_expanded)]() mutable {
+    expand_paths(std::move(paths), std::move(on_expanded));
+  };
+
+  auto it = directories.find(dir_path.string());
+  if(it != directories.end()) {
+    if(it->second.updating)
+      it->second.on_updated.emplace_back(std::move(expand_next));
+    else
+      expand_next();
+    return;
   }
 
-  //set cursor at select_path
-  tree_store->foreach_iter([this, &select_path](const Gtk::TreeModel::iterator &iter) {
-    if(iter->get_value(column_record.path) == select_path) {
-      auto tree_path = Gtk::TreePath(iter);
-      expand_to_path(tree_path);
-      set_cursor(tree_path);
+  tree_store->foreach_iter([this, &dir_path, &expand_next](const Gtk::TreeModel::iterator &iter) {
+    if(iter->get_value(column_record.path) == dir_path) {
+      add_or_update_path(dir_path, *iter, true, std::move(expand_next));
       return true;
     }
     return false;
@@ -627,7 +528,7 @@ bool Directories::on_button_press_event(GdkEventButton *event) {
   return Gtk::TreeView::on_button_press_event(event);
 }
 
-void Directories::add_or_update_path(const boost::filesystem::path &dir_path, const Gtk::TreeModel::Row &row, bool include_parent_paths) {
+void Directories::add_or_update_path(const boost::filesystem::path &dir_path, const Gtk::TreeModel::Row &row, bool include_parent_paths, std::function<void()> on_updated) {
   auto path_it = directories.find(dir_path.string());
   if(!boost::filesystem::exists(dir_path)) {
     if(path_it != directories.end())
@@ -649,11 +550,15 @@ void Directories::add_or_update_path(const boost::filesystem::path &dir_path, co
     }
 
     monitor->signal_changed().connect([this, connection, path_and_row, repository](const Glib::RefPtr<Gio::File> &file,
-                                                                                   const Glib::RefPtr<Gio::File> &,
+                                                                                   const Glib::RefPtr<Gio::File> &other_file,
                                                                                    Gio::FileMonitorEvent monitor_event) {
       if(monitor_event != Gio::FileMonitorEvent::FILE_MONITOR_EVENT_CHANGES_DONE_HINT) {
-        if(repository)
-          repository->clear_saved_status();
+        if(repository) {
+          if(file)
+            repository->clear_saved_status(file->get_path());
+          if(other_file)
+            repository->clear_saved_status(other_file->get_path());
+        }
         connection->disconnect();
         *connection = Glib::signal_timeout().connect([path_and_row, this]() {
           if(directories.find(path_and_row->first.string()) != directories.end())
@@ -686,65 +591,230 @@ void Directories::add_or_update_path(const boost::filesystem::path &dir_path, co
     directories[dir_path.string()] = {row, monitor, repository, repository_connection};
   }
 
-  Gtk::TreeNodeChildren children(row ? row.children() : tree_store->children());
-  if(children) {
-    if(children.begin()->get_value(column_record.path) == "")
-      tree_store->erase(children.begin());
-  }
-  std::unordered_set<std::string> not_deleted;
-  boost::filesystem::directory_iterator end_it;
-  for(boost::filesystem::directory_iterator it(dir_path); it != end_it; it++) {
-    auto filename = it->path().filename().string();
-    bool already_added = false;
-    if(children) {
-      for(auto &child : children) {
-        if(child->get_value(column_record.name) == filename) {
-          not_deleted.emplace(filename);
-          already_added = true;
-          break;
-        }
-      }
+  auto &directory = directories[dir_path.string()];
+  directory.update_id = ++update_count;
+  directory.updating = true;
+  if(on_updated)
+    directory.on_updated.emplace_back(std::move(on_updated));
+
+  // Listing and sorting large directories is done in a separate thread to keep the user interface responsive
+  std::thread listing_thread([this, dir_path = dir_path.string(), update_id = directory.update_id, include_parent_paths] {
+    auto listing = std::make_shared<Listing>();
+    boost::system::error_code ec;
+    for(boost::filesystem::directory_iterator it(dir_path, ec), end; it != end; it.increment(ec)) {
+      if(ec)
+        break;
+      listing->entries.emplace_back(Listing::Entry{it->path().filename().string(), it->path(), boost::filesystem::is_directory(it->path(), ec)});
     }
-    if(!already_added) {
-      auto child = tree_store->append(children);
-      not_deleted.emplace(filename);
-      auto is_directory = boost::filesystem::is_directory(it->path());
-      child->set_value(column_record.is_directory, is_directory);
-      child->set_value(column_record.name, filename);
-      child->set_value(column_record.markup, Glib::Markup::escape_text(filename));
-      child->set_value(column_record.path, it->path());
-      if(is_directory) {
-        auto grandchild = tree_store->append(child->children());
-        grandchild->set_value(column_record.is_directory, false);
-        grandchild->set_value(column_record.name, std::string("(empty)"));
-        grandchild->set_value(column_record.markup, Glib::Markup::escape_text("(empty)"));
-        grandchild->set_value(column_record.type, PathType::UNKNOWN);
-      }
-      else {
-        auto language = Source::guess_language(it->path().filename());
-        if(!language)
-          child->set_value(column_record.type, PathType::UNKNOWN);
-      }
+    std::sort(listing->entries.begin(), listing->entries.end(), entry_less);
+
+    dispatcher.post([this, dir_path, update_id, listing = std::move(listing), include_parent_paths] {
+      add_entries(dir_path, update_id, listing, include_parent_paths);
+    });
+  });
+  listing_thread.detach();
+}
+
+void Directories::add_entries(const std::string &dir_path, size_t update_id, const std::shared_ptr<Listing> &listing, bool include_parent_paths) {
+  auto it = directories.find(dir_path);
+  if(it == directories.end() || it->second.update_id != update_id)
+    return;
+
+  Gtk::TreeNodeChildren children(it->second.row ? it->second.row.children() : tree_store->children());
+  if(listing->next_entry == 0) {
+    for(auto &child : children) {
+      if(!child.get_value(column_record.path).empty())
+        listing->rows.emplace(child.get_value(column_record.name), child);
     }
   }
-  if(children) {
-    for(auto it = children.begin(); it != children.end();) {
-      if(not_deleted.count(it->get_value(column_record.name)) == 0) {
-        it = tree_store->erase(it);
-      }
-      else
-        it++;
+
+  // Entries are added in batches, so that the user interface is not blocked by large directories
+  auto end = std::min(listing->next_entry + 500, listing->entries.size());
+  for(; listing->next_entry < end; ++listing->next_entry) {
+    auto &entry = listing->entries[listing->next_entry];
+    // Existing rows are kept, and are already in the same order as the entries
+    auto row_it = listing->rows.find(entry.name);
+    if(row_it != listing->rows.end()) {
+      listing->previous_row = row_it->second;
+      listing->rows.erase(row_it);
+      continue;
+    }
+    auto child = listing->previous_row ? tree_store->insert_after(listing->previous_row) : tree_store->prepend(children);
+    listing->previous_row = child;
+    child->set_value(column_record.is_directory, entry.is_directory);
+    child->set_value(column_record.name, entry.name);
+    child->set_value(column_record.markup, Glib::Markup::escape_text(entry.name));
+    child->set_value(column_record.path, entry.path);
+    if(entry.is_directory) {
+      auto grandchild = tree_store->append(child->children());
+      grandchild->set_value(column_record.is_directory, false);
+      grandchild->set_value(column_record.name, std::string("(empty)"));
+      grandchild->set_value(column_record.markup, Glib::Markup::escape_text("(empty)"));
+      grandchild->set_value(column_record.type, PathType::UNKNOWN);
+    }
+    else {
+      auto language = Source::guess_language(entry.path.filename());
+      if(!language)
+        child->set_value(column_record.type, PathType::UNKNOWN);
     }
   }
-  if(!children) {
-    auto child = tree_store->append(children);
+  if(listing->next_entry < listing->entries.size()) {
+    dispatcher.post([this, dir_path, update_id, listing, include_parent_paths] {
+      add_entries(dir_path, update_id, listing, include_parent_paths);
+    });
+    return;
+  }
+
+  // The empty row is added before the removed rows are erased, so that an expanded row is not collapsed
+  if(listing->entries.empty() && !(children && children.begin()->get_value(column_record.path).empty())) {
+    auto child = tree_store->prepend(children);
     child->set_value(column_record.is_directory, false);
     child->set_value(column_record.name, std::string("(empty)"));
     child->set_value(column_record.markup, Glib::Markup::escape_text("(empty)"));
     child->set_value(column_record.type, PathType::UNKNOWN);
   }
+  for(auto child_it = children.begin(); child_it != children.end();) {
+    auto path = child_it->get_value(column_record.path);
+    if(path.empty() ? !listing->entries.empty() : listing->rows.count(child_it->get_value(column_record.name)) > 0) {
+      if(child_it->get_value(column_record.is_directory)) {
+        for(auto directory_it = directories.begin(); directory_it != directories.end();) {
+          if(filesystem::file_in_path(directory_it->first, path))
+            directory_it = directories.erase(directory_it);
+          else
+            ++directory_it;
+        }
+      }
+      child_it = tree_store->erase(child_it);
+    }
+    else
+      ++child_it;
+  }
+
+  it = directories.find(dir_path);
+  it->second.updating = false;
+  auto on_updated = std::move(it->second.on_updated);
+  it->second.on_updated.clear();
 
   colorize_path(dir_path, include_parent_paths);
+  for(auto &function : on_updated)
+    function();
+}
+
+bool Directories::entry_less(const Listing::Entry &entry1, const Listing::Entry &entry2) {
+  /// Natural comparison supporting UTF-8 and locale
+  struct Natural {
+    static bool is_digit(char chr) {
+      return chr >= '0' && chr <= '9';
+    }
+
+    static int compare_characters(size_t &i1, size_t &i2, const std::string &s1, const std::string &s2) {
+      ScopeGuard scope_guard{[&i1, &i2] {
+        ++i1;
+        ++i2;
+      }};
+      auto c1 = static_cast<unsigned char>(s1[i1]);
+      auto c2 = static_cast<unsigned char>(s2[i2]);
+      if(c1 < 0b10000000 && c2 < 0b10000000) { // Both characters are ascii
+        auto at = std::tolower(s1[i1]);
+        auto bt = std::tolower(s2[i2]);
+        if(at < bt)
+          return -1;
+        else if(at == bt)
+          return 0;
+        else
+          return 1;
+      }
+
+      Glib::ustring u1;
+      if(c1 >= 0b11110000)
+        u1 = s1.substr(i1, 4);
+      else if(c1 >= 0b11100000)
+        u1 = s1.substr(i1, 3);
+      else if(c1 >= 0b11000000)
+        u1 = s1.substr(i1, 2);
+      else
+        u1 = s1[i1];
+
+      Glib::ustring u2;
+      if(c2 >= 0b11110000)
+        u2 = s2.substr(i2, 4);
+      else if(c2 >= 0b11100000)
+        u2 = s2.substr(i2, 3);
+      else if(c2 >= 0b11000000)
+        u2 = s2.substr(i2, 2);
+      else
+        u2 = s2[i2];
+
+      i1 += u1.bytes() - 1;
+      i2 += u2.bytes() - 1;
+
+      u1 = u1.lowercase();
+      u2 = u2.lowercase();
+
+      if(u1 < u2)
+        return -1;
+      else if(u1 == u2)
+        return 0;
+      else
+        return 1;
+    }
+
+    static int compare_numbers(size_t &i1, size_t &i2, const std::string &s1, const std::string &s2) {
+      int result = 0;
+      while(true) {
+        if(i1 >= s1.size() || !is_digit(s1[i1])) {
+          if(i2 >= s2.size() || !is_digit(s2[i2])) // a and b has equal number of digits
+            return result;
+          return -1; // a has fewer digits
+        }
+        if(i2 >= s2.size() || !is_digit(s2[i2]))
+          return 1; // b has fewer digits
+
+        if(result == 0) {
+          if(s1[i1] < s2[i2])
+            result = -1;
+          if(s1[i1] > s2[i2])
+            result = 1;
+        }
+        ++i1;
+        ++i2;
+      }
+    }
+
+    static int compare(const std::string &s1, const std::string &s2) {
+      size_t i1 = 0;
+      size_t i2 = 0;
+      while(i1 < s1.size() && i2 < s2.size()) {
+        if(is_digit(s1[i1]) && !is_digit(s2[i2]))
+          return -1;
+        if(!is_digit(s1[i1]) && is_digit(s2[i2]))
+          return 1;
+        if(!is_digit(s1[i1]) && !is_digit(s2[i2])) {
+          auto result = compare_characters(i1, i2, s1, s2);
+          if(result != 0)
+            return result;
+        }
+        else {
+          auto result = compare_numbers(i1, i2, s1, s2);
+          if(result != 0)
+            return result;
+        }
+      }
+      if(i1 >= s1.size() && i2 >= s2.size()) // Equal regardless of case, so names that only differ in case still get a strict order
+        return s1 < s2 ? -1 : (s1 == s2 ? 0 : 1);
+      if(i1 >= s1.size())
+        return -1;
+      return 1;
+    }
+  };
+
+  std::string prefix1, prefix2;
+  prefix1 += entry1.is_directory ? 'a' : 'b';
+  prefix2 += entry2.is_directory ? 'a' : 'b';
+  prefix1 += !entry1.name.empty() && entry1.name[0] == '.' ? 'a' : 'b';
+  prefix2 += !entry2.name.empty() && entry2.name[0] == '.' ? 'a' : 'b';
+
+  return Natural::compare(prefix1 + entry1.name, prefix2 + entry2.name) < 0;
 }
 
 void Directories::remove_path(const boost::filesystem::path &dir_path) {
@@ -772,91 +842,129 @@ void Directories::remove_path(const boost::filesystem::path &dir_path) {
   }
 }
 
-void Directories::colorize_path(boost::filesystem::path dir_path_, bool include_parent_paths) {
-  auto dir_path = std::make_shared<boost::filesystem::path>(std::move(dir_path_));
-  auto it = directories.find(dir_path->string());
-  if(it == directories.end())
+void Directories::colorize_path(const boost::filesystem::path &dir_path, bool include_parent_paths) {
+  auto it = directories.find(dir_path.string());
+  if(it == directories.end() || !it->second.repository)
     return;
 
-  if(it != directories.end() && it->second.repository) {
-    auto repository = it->second.repository;
-    std::thread git_status_thread([this, dir_path, repository, include_parent_paths] {
-      Git::Repository::Status status;
-      try {
-        status = repository->get_status();
-      }
-      catch(const std::exception &e) {
-        Terminal::get().async_print(std::string("Error (git): ") + e.what() + '\n', true);
-      }
+  auto &colorization = colorizations[it->second.repository.get()];
+  colorization.repository = it->second.repository;
+  auto &include = colorization.paths[it->first];
+  include = include || include_parent_paths;
+  schedule_colorization(colorization);
+}
 
-      dispatcher.post([this, dir_path, include_parent_paths, status = std::move(status)] {
-        auto it = directories.find(dir_path->string());
-        if(it == directories.end())
-          return;
+void Directories::schedule_colorization(Colorization &colorization) {
+  if(colorization.scheduled || colorization.running)
+    return;
+  colorization.scheduled = true;
+  // Requests that arrive before the timeout, or while the status is read, are handled by the same status read
+  Glib::signal_timeout().connect([this, repository = colorization.repository.get()] {
+    auto it = colorizations.find(repository);
+    if(it != colorizations.end())
+      read_status(it->second);
+    return false;
+  }, 100);
+}
 
-        auto normal_color = get_style_context()->get_color(Gtk::StateFlags::STATE_FLAG_NORMAL);
-        Gdk::RGBA gray;
-        gray.set_rgba(0.5, 0.5, 0.5);
-        Gdk::RGBA yellow;
-        yellow.set_rgba(1.0, 1.0, 0.2);
-        double factor = 0.5;
-        yellow.set_red(normal_color.get_red() + factor * (yellow.get_red() - normal_color.get_red()));
-        yellow.set_green(normal_color.get_green() + factor * (yellow.get_green() - normal_color.get_green()));
-        yellow.set_blue(normal_color.get_blue() + factor * (yellow.get_blue() - normal_color.get_blue()));
-        Gdk::RGBA green;
-        green.set_rgba(0.0, 1.0, 0.0);
-        factor = 0.4;
-        green.set_red(normal_color.get_red() + factor * (green.get_red() - normal_color.get_red()));
-        green.set_green(normal_color.get_green() + factor * (green.get_green() - normal_color.get_green()));
-        green.set_blue(normal_color.get_blue() + factor * (green.get_blue() - normal_color.get_blue()));
-
-        do {
-          Gtk::TreeNodeChildren children(it->second.row ? it->second.row.children() : tree_store->children());
-          if(!children)
-            return;
-
-          for(auto &child : children) {
-            auto name = Glib::Markup::escape_text(child.get_value(column_record.name));
-            auto path = child.get_value(column_record.path);
-            // Use canonical path to follow symbolic links
-            boost::system::error_code ec;
-            auto canonical_path = boost::filesystem::canonical(path, ec);
-            if(ec)
-              canonical_path = path;
-
-            Gdk::RGBA *color;
-            if(status.modified.find(canonical_path.generic_string()) != status.modified.end())
-              color = &yellow;
-            else if(status.added.find(canonical_path.generic_string()) != status.added.end())
-              color = &green;
-            else
-              color = &normal_color;
-
-            std::stringstream ss;
-            ss << '#' << std::setfill('0') << std::hex;
-            ss << std::setw(2) << std::hex << (color->get_red_u() >> 8);
-            ss << std::setw(2) << std::hex << (color->get_green_u() >> 8);
-            ss << std::setw(2) << std::hex << (color->get_blue_u() >> 8);
-            child.set_value(column_record.markup, "<span foreground=\"" + ss.str() + "\">" + name + "</span>");
-
-            auto type = child.get_value(column_record.type);
-            if(type == PathType::UNKNOWN)
-              child.set_value(column_record.markup, "<i>" + child.get_value(column_record.markup) + "</i>");
-          }
+void Directories::read_status(Colorization &colorization) {
+  colorization.scheduled = false;
+  colorization.running = true;
+  std::thread git_status_thread([this, repository = colorization.repository, paths = std::move(colorization.paths)] {
+    Git::Repository::Status status;
+    try {
+      status = repository->get_status();
+    }
+    catch(const std::exception &e) {
+      Terminal::get().async_print(std::string("Error (git): ") + e.what() + '\n', true);
+    }
 
-          if(!include_parent_paths)
-            break;
-
-          auto path = boost::filesystem::path(it->first);
-          if(boost::filesystem::exists(path / ".git"))
-            break;
-          if(path == path.root_directory())
-            break;
-          auto parent_path = boost::filesystem::path(it->first).parent_path();
-          it = directories.find(parent_path.string());
-        } while(it != directories.end());
-      });
+    dispatcher.post([this, repository, paths = std::move(paths), status = std::move(status)] {
+      for(auto &path : paths)
+        set_colors(path.first, path.second, status);
+
+      auto it = colorizations.find(repository.get());
+      if(it == colorizations.end())
+        return;
+      it->second.running = false;
+      if(!it->second.paths.empty())
+        schedule_colorization(it->second);
+      else
+        colorizations.erase(it);
     });
-    git_status_thread.detach();
-  }
+  });
+  git_status_thread.detach();
+  colorization.paths.clear();
+}
+
+void Directories::set_colors(const std::string &dir_path, bool include_parent_paths, const Git::Repository::Status &status) {
+  auto it = directories.find(dir_path);
+  if(it == directories.end())
+    return;
+
+  auto normal_color = get_style_context()->get_color(Gtk::StateFlags::STATE_FLAG_NORMAL);
+  Gdk::RGBA gray;
+  gray.set_rgba(0.5, 0.5, 0.5);
+  Gdk::RGBA yellow;
+  yellow.set_rgba(1.0, 1.0, 0.2);
+  double factor = 0.5;
+  yellow.set_red(normal_color.get_red() + factor * (yellow.get_red() - normal_color.get_red()));
+  yellow.set_green(normal_color.get_green() + factor * (yellow.get_green() - normal_color.get_green()));
+  yellow.set_blue(normal_color.get_blue() + factor * (yellow.get_blue() - normal_color.get_blue()));
+  Gdk::RGBA green;
+  green.set_rgba(0.0, 1.0, 0.0);
+  factor = 0.4;
+  green.set_red(normal_color.get_red() + factor * (green.get_red() - normal_color.get_red()));
+  green.set_green(normal_color.get_green() + factor * (green.get_green() - normal_color.get_green()));
+  green.set_blue(normal_color.get_blue() + factor * (green.get_blue() - normal_color.get_blue()));
+
+  do {
+    Gtk::TreeNodeChildren children(it->second.row ? it->second.row.children() : tree_store->children());
+    if(!children)
+      return;
+
+    for(auto &child : children) {
+      auto name = Glib::Markup::escape_text(child.get_value(column_record.name));
+      auto path = child.get_value(column_record.path);
+      // Use canonical path to follow symbolic links
+      boost::system::error_code ec;
+      auto canonical_path = boost::filesystem::canonical(path, ec);
+      if(ec)
+        canonical_path = path;
+
+      Gdk::RGBA *color;
+      if(status.is_modified(canonical_path))
+        color = &yellow;
+      else if(status.is_added(canonical_path))
+        color = &green;
+      else
+        color = &normal_color;
+
+      std::stringstream ss;
+      ss << '#' << std::setfill('0') << std::hex;
+      ss << std::setw(2) << std::hex << (color->get_red_u() >> 8);
+      ss << std::setw(2) << std::hex << (color->get_green_u() >> 8);
+      ss << std::setw(2) << std::hex << (color->get_blue_u() >> 8);
+      Glib::ustring markup = "<span foreground=\"" + ss.str() + "\">" + name + "</span>";
+
+      auto type = child.get_value(column_record.type);
+      if(type == PathType::UNKNOWN)
+        markup = "<i>" + markup + "</i>";
+
+      // Only rows whose color has changed are updated, since each update redraws the row
+      if(child.get_value(column_record.markup) != markup)
+        child.set_value(column_record.markup, markup);
+    }
+
+    if(!include_parent_paths)
+      break;
+
+    auto path = boost::filesystem::path(it->first);
+    if(boost::filesystem::exists(path / ".git"))
+      break;
+    if(path == path.root_directory())
+      break;
+    auto parent_path = boost::filesystem::path(it->first).parent_path();
+    it = directories.find(parent_path.string());
+  } while(it != directories.end());
 }
@@ -3,7 +3,9 @@
 #include "dispatcher.h"
 #include "git.h"
 #include <atomic>
+#include <functional>
 #include <gtkmm.h>
+#include <map>
 #include <string>
 #include <thread>
 #include <unordered_map>
@@ -17,6 +19,38 @@ class Directories : public Gtk::ListViewText {
     Glib::RefPtr<Gio::FileMonitor> monitor;
     std::shared_ptr<Git::Repository> repository;
     std::shared_ptr<sigc::connection> connection;
+    /// Identifies the latest listing of the directory, so that results of older listings are discarded
+    size_t update_id = 0;
+    bool updating = false;
+    /// Called when the current listing has been added to the tree
+    std::vector<std::function<void()>> on_updated;
+  };
+
+  /// Directory entries that are listed and sorted in a separate thread, and then added to the tree in batches
+  class Listing {
+  public:
+    class Entry {
+    public:
+      std::string name;
+      boost::filesystem::path path;
+      bool is_directory;
+    };
+
+    std::vector<Entry> entries;
+    size_t next_entry = 0;
+    /// Rows that were in the tree before the listing, by name
+    std::unordered_map<std::string, Gtk::TreeModel::iterator> rows;
+    Gtk::TreeModel::iterator previous_row;
+  };
+
+  /// Pending colorization of the directories of a repository
+  class Colorization {
+  public:
+    std::shared_ptr<Git::Repository> repository;
+    /// Directories to colorize when the status has been read, and whether to also colorize their parent directories
+    std::map<std::string, bool> paths;
+    bool scheduled = false;
+    bool running = false;
   };
 
   enum class PathType { KNOWN, UNKNOWN };
@@ -69,14 +103,30 @@ protected:
   bool on_button_press_event(GdkEventButton *event) override;
 
 private:
-  void add_or_update_path(const boost::filesystem::path &dir_path, const Gtk::TreeModel::Row &row, bool include_parent_paths);
+  /// Lists dir_path in a separate thread and updates its rows. on_updated is called when the rows have been updated.
+  void add_or_update_path(const boost::filesystem::path &dir_path, const Gtk::TreeModel::Row &row, bool include_parent_paths, std::function<void()> on_updated = nullptr);
+  /// Adds the next batch of entries to the rows of dir_path, unless a newer listing of dir_path has been started
+  void add_entries(const std::string &dir_path, size_t update_id, const std::shared_ptr<Listing> &listing, bool include_parent_paths);
+  /// Directories first, then hidden files, then natural order supporting UTF-8 and locale
+  static bool entry_less(const Listing::Entry &entry1, const Listing::Entry &entry2);
+  /// Expands paths, from the back, one at a time as their rows are added to the tree, and then calls on_expanded
+  void expand_paths(std::vector<boost::filesystem::path> paths, std::function<void()> on_expanded);
   void remove_path(const boost::filesystem::path &dir_path);
-  void colorize_path(boost::filesystem::path dir_path_, bool include_parent_paths);
+  /// Colors the rows of dir_path from the git status. Requests are coalesced per repository, with at most one status read at a time.
+  void colorize_path(const boost::filesystem::path &dir_path, bool include_parent_paths);
+  void schedule_colorization(Colorization &colorization);
+  void read_status(Colorization &colorization);
+  void set_colors(const std::string &dir_path, bool include_parent_paths, const Git::Repository::Status &status);
 
   Glib::RefPtr<Gtk::TreeStore> tree_store;
   TreeStore::ColumnRecord column_record;
 
   std::unordered_map<std::string, DirectoryData> directories;
+  size_t update_count = 0;
+
+  std::unordered_map<Git::Repository *, Colorization> colorizations;
+  /// Periodically colorizes all directories
+  sigc::connection colorize_connection;
 
   Dispatcher dispatcher;
 
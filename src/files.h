@@ -65,7 +65,9 @@ const std::string default_config_file = R"RAW({
         "clang_format_style_comment": "IndentWidth, AccessModifierOffset and UseTab are set automatically. See http://clang.llvm.org/docs/ClangFormatStyleOptions.html",
         "clang_format_style": "ColumnLimit: 0, NamespaceIndentation: All",
         "clang_usages_threads_comment": "The number of threads used in finding usages in unparsed files. -1 corresponds to the number of cores available, and 0 disables the search",
-        "clang_usages_threads": -1
+        "clang_usages_threads": -1,
+        "restored_tabs_parsed_at_startup_comment": "The number of the most recently opened tabs from the last session that are parsed at startup. The remaining restored tabs are parsed, or opened in their language server, when first shown. -1 parses all restored tabs at startup",
+        "restored_tabs_parsed_at_startup": 1
     },
     "terminal": {
         "history_size": 1000,
@@ -95,6 +97,7 @@ const std::string default_config_file = R"RAW({
         "edit_shrink_selection": "<primary><shift><alt>a",
         "edit_show_or_hide": "",
         "edit_find": "<primary>f",
+        "edit_find_in_project": "<primary><alt>f",
         "source_spellcheck": "",
         "source_spellcheck_clear": "",
         "source_spellcheck_next_error": "<primary><shift>e",
@@ -125,6 +128,8 @@ const std::string default_config_file = R"RAW({
         "project_set_run_arguments": "",
         "project_compile_and_run": "<primary>Return",
         "project_compile": "<primary><shift>Return",
+        "project_goto_next_build_error": "<primary><alt>e",
+        "project_goto_previous_build_error": "<primary><alt><shift>e",
         "project_run_command": "<alt>Return",
         "project_kill_last_running": "<primary>Escape",
         "project_force_kill_last_running": "<primary><shift>Escape",
@@ -188,6 +193,8 @@ const std::string default_config_file = R"RAW({
         "save_on_compile_or_run": true,
         "clear_terminal_on_compile": true,
         "ctags_command": "ctags",
+        "trigram_index_comment": "Keep an index of the trigrams in the project files, stored in the build directory, so that Find in Project and Find Usages only read the files that may contain the searched text",
+        "trigram_index": false,
         "python_command": "PYTHONUNBUFFERED=1 python"
     },
     "documentation_searches": {
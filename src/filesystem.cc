@@ -198,6 +198,10 @@ boost::filesystem::path filesystem::get_relative_path(const boost::filesystem::p
   return relative_path;
 }
 
+std::time_t filesystem::get_stable_last_write_time(std::time_t last_write_time, std::time_t now) noexcept {
+  return last_write_time < now - 1 ? last_write_time : 0;
+}
+
 boost::filesystem::path filesystem::get_executable(const boost::filesystem::path &executable_name) noexcept {
 #if defined(__APPLE__) || defined(_WIN32)
   return executable_name;
@@ -1,5 +1,6 @@
 #pragma once
 #include <boost/filesystem.hpp>
+#include <ctime>
 #include <string>
 #include <vector>
 
@@ -33,6 +34,10 @@ public:
 
   static boost::filesystem::path get_relative_path(const boost::filesystem::path &path, const boost::filesystem::path &base) noexcept;
 
+  /// Returns last_write_time, or 0 if it is within a second of now. Last write times only have a resolution of one second,
+  /// so a file or directory that was changed this recently must be checked again even if its last write time is unchanged.
+  static std::time_t get_stable_last_write_time(std::time_t last_write_time, std::time_t now = std::time(nullptr)) noexcept;
+
   /// Return executable with latest version in filename on systems that is lacking executable_name symbolic link
   static boost::filesystem::path get_executable(const boost::filesystem::path &executable_name) noexcept;
 
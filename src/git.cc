@@ -1,10 +1,11 @@
 #include "git.h"
+#include "filesystem.h"
 #include <cstring>
 #include <unordered_map>
 
+Mutex Git::initialized_mutex;
 bool Git::initialized = false;
-Mutex Git::mutex;
-Git::Error Git::error;
+thread_local Git::Error Git::error;
 
 std::string Git::Error::message() noexcept {
 #if LIBGIT2_VER_MAJOR > 0 || (LIBGIT2_VER_MAJOR == 0 && LIBGIT2_VER_MINOR >= 28)
@@ -18,24 +19,34 @@ std::string Git::Error::message() noexcept {
     return last_error->message;
 }
 
-Git::Repository::Diff::Diff(const boost::filesystem::path &path, git_repository *repository) {
-  blob = std::shared_ptr<git_blob>(nullptr, [](git_blob *blob) {
-    if(blob)
-      git_blob_free(blob);
-  });
-  auto spec = "HEAD:" + path.generic_string();
-  LockGuard lock(mutex);
-  error.code = git_revparse_single(reinterpret_cast<git_object **>(&blob), repository, spec.c_str());
-  if(error)
-    throw std::runtime_error(error.message());
-
+Git::Repository::Diff::Diff(std::shared_ptr<git_blob> blob_, std::shared_ptr<Mutex> mutex_) : mutex(std::move(mutex_)), blob(std::move(blob_)) {
   git_diff_init_options(&options, GIT_DIFF_OPTIONS_VERSION);
   options.context_lines = 0;
 }
 
+Git::Repository::Diff::Lines Git::Repository::Diff::get_lines(const std::vector<Hunk> &hunks) {
+  Lines lines;
+  for(auto &hunk : hunks) {
+    auto start = hunk.new_lines.first - 1;
+    auto end = hunk.new_lines.first + hunk.new_lines.second - 1;
+    if(hunk.old_lines.second == 0 && hunk.new_lines.second > 0)
+      lines.added.emplace_back(start, end);
+    else if(hunk.new_lines.second == 0 && hunk.old_lines.second > 0)
+      lines.removed.emplace_back(start);
+    else
+      lines.modified.emplace_back(start, end);
+  }
+  return lines;
+}
+
+std::string Git::Repository::Diff::get_old_buffer() {
+  LockGuard lock(*mutex);
+  return std::string(static_cast<const char *>(git_blob_rawcontent(blob.get())), git_blob_rawsize(blob.get()));
+}
+
 Git::Repository::Diff::Lines Git::Repository::Diff::get_lines(const std::string &buffer) {
   Lines lines;
-  LockGuard lock(mutex);
+  LockGuard lock(*mutex);
   error.code = git_diff_blob_to_buffer(blob.get(), nullptr, buffer.c_str(), buffer.size(), nullptr, &options, nullptr, nullptr, [](const git_diff_delta *delta, const git_diff_hunk *hunk, void *payload) {
     //Based on https://github.com/atom/git-diff/blob/master/lib/git-diff-view.coffee
     auto lines = static_cast<Lines *>(payload);
@@ -57,7 +68,6 @@ Git::Repository::Diff::Lines Git::Repository::Diff::get_lines(const std::string
 
 std::vector<Git::Repository::Diff::Hunk> Git::Repository::Diff::get_hunks(const std::string &old_buffer, const std::string &new_buffer) {
   std::vector<Git::Repository::Diff::Hunk> hunks;
-  LockGuard lock(mutex);
   initialize();
   git_diff_options options;
   git_diff_init_options(&options, GIT_DIFF_OPTIONS_VERSION);
@@ -75,7 +85,7 @@ std::vector<Git::Repository::Diff::Hunk> Git::Repository::Diff::get_hunks(const
 std::string Git::Repository::Diff::get_details(const std::string &buffer, int line_nr) {
   std::pair<std::string, int> details;
   details.second = line_nr;
-  LockGuard lock(mutex);
+  LockGuard lock(*mutex);
   error.code = git_diff_blob_to_buffer(blob.get(), nullptr, buffer.c_str(), buffer.size(), nullptr, &options, nullptr, nullptr, nullptr, [](const git_diff_delta *delta, const git_diff_hunk *hunk, const git_diff_line *line, void *payload) {
     auto details = static_cast<std::pair<std::string, int> *>(payload);
     auto line_nr = details->second;
@@ -93,14 +103,11 @@ std::string Git::Repository::Diff::get_details(const std::string &buffer, int li
   return details.first;
 }
 
-Git::Repository::Repository(const boost::filesystem::path &path) {
+Git::Repository::Repository(const boost::filesystem::path &path) : mutex(std::make_shared<Mutex>()) {
   git_repository *repository_ptr;
-  {
-    LockGuard lock(mutex);
-    error.code = git_repository_open_ext(&repository_ptr, path.generic_string().c_str(), 0, nullptr);
-    if(error)
-      throw std::runtime_error(error.message());
-  }
+  error.code = git_repository_open_ext(&repository_ptr, path.generic_string().c_str(), 0, nullptr);
+  if(error)
+    throw std::runtime_error(error.message());
   repository = std::unique_ptr<git_repository, std::function<void(git_repository *)>>(repository_ptr, [](git_repository *ptr) {
     git_repository_free(ptr);
   });
@@ -112,10 +119,28 @@ Git::Repository::Repository(const boost::filesystem::path &path) {
   auto git_directory = Gio::File::create_for_path(get_path().string());
   monitor = git_directory->monitor_directory(Gio::FileMonitorFlags::FILE_MONITOR_WATCH_MOVES);
   monitor_changed_connection = monitor->signal_changed().connect([this](const Glib::RefPtr<Gio::File> &file,
-                                                                        const Glib::RefPtr<Gio::File> &,
+                                                                        const Glib::RefPtr<Gio::File> &other_file,
                                                                         Gio::FileMonitorEvent monitor_event) {
     if(monitor_event != Gio::FileMonitorEvent::FILE_MONITOR_EVENT_CHANGES_DONE_HINT) {
-      this->clear_saved_status();
+      // Lock files are temporary, and a changed index only requires the status of some paths to be read again
+      bool index = false, other = false;
+      for(auto &changed_file : {file, other_file}) {
+        if(!changed_file)
+          continue;
+        auto name = changed_file->get_basename();
+        if(name == "index")
+          index = true;
+        else if(!(name.size() > 5 && name.compare(name.size() - 5, 5, ".lock") == 0))
+          other = true;
+      }
+      if(other || index)
+        clear_head_blobs();
+      if(other)
+        this->clear_saved_status();
+      else if(index) {
+        LockGuard lock(saved_status_mutex);
+        index_changed = true;
+      }
     }
   }, false);
 }
@@ -124,84 +149,243 @@ Git::Repository::~Repository() {
   monitor_changed_connection.disconnect();
 }
 
+void Git::Repository::Status::add(const std::string &path, STATUS status) {
+  if(files.count(path))
+    remove(path);
+  files.emplace(path, status);
+  auto node = &root;
+  size_t start = 0;
+  while(start < path.size()) {
+    auto end = path.find('/', start);
+    if(end == std::string::npos)
+      end = path.size();
+    node = &node->children[path.substr(start, end - start)];
+    if(status == STATUS::NEW)
+      ++node->added;
+    else
+      ++node->modified;
+    start = end + 1;
+  }
+}
+
+void Git::Repository::Status::remove(const std::string &path) {
+  for(auto it = files.lower_bound(path); it != files.end() && it->first.compare(0, path.size(), path) == 0;) {
+    // Skip for instance a-b when removing a, since a-b is sorted between a and a/b
+    if(it->first.size() != path.size() && it->first[path.size()] != '/' && !path.empty()) {
+      ++it;
+      continue;
+    }
+
+    std::vector<std::pair<Node *, std::map<std::string, Node>::iterator>> nodes;
+    auto node = &root;
+    size_t start = 0;
+    while(start < it->first.size()) {
+      auto end = it->first.find('/', start);
+      if(end == std::string::npos)
+        end = it->first.size();
+      auto child = node->children.find(it->first.substr(start, end - start));
+      if(child == node->children.end())
+        break;
+      if(it->second == STATUS::NEW)
+        --child->second.added;
+      else
+        --child->second.modified;
+      nodes.emplace_back(node, child);
+      node = &child->second;
+      start = end + 1;
+    }
+    for(auto node_it = nodes.rbegin(); node_it != nodes.rend(); ++node_it) {
+      if(node_it->second->second.added == 0 && node_it->second->second.modified == 0)
+        node_it->first->children.erase(node_it->second);
+    }
+
+    it = files.erase(it);
+  }
+}
+
+const Git::Repository::Status::Node *Git::Repository::Status::find(const boost::filesystem::path &path) const {
+  if(!filesystem::file_in_path(path, work_path))
+    return nullptr;
+  auto node = &root;
+  auto it = path.begin();
+  std::advance(it, std::distance(work_path.begin(), work_path.end()));
+  if(it == path.end())
+    return nullptr;
+  for(; it != path.end(); ++it) {
+    auto child = node->children.find(it->string());
+    if(child == node->children.end())
+      return nullptr;
+    node = &child->second;
+  }
+  return node;
+}
+
+bool Git::Repository::Status::is_added(const boost::filesystem::path &path) const {
+  auto node = find(path);
+  return node && node->added > 0;
+}
+
+bool Git::Repository::Status::is_modified(const boost::filesystem::path &path) const {
+  auto node = find(path);
+  return node && node->modified > 0;
+}
+
 Git::Repository::Status Git::Repository::get_status() {
   {
     LockGuard lock(saved_status_mutex);
-    if(has_saved_status)
+    if(has_saved_status && std::chrono::steady_clock::now() - full_update_time >= full_update_interval)
+      has_saved_status = false;
+    if(has_saved_status && changed_paths.empty() && !index_changed && !updating_saved_status)
       return saved_status;
   }
 
-  struct Data {
-    const boost::filesystem::path &work_path;
-    Status status = {};
-  };
-  Data data{work_path};
+  LockGuard lock(*mutex);
+  Status status;
+  bool full_update;
+  std::set<std::string> paths;
+  bool read_index;
   {
-    LockGuard lock(mutex);
-    error.code = git_status_foreach(repository.get(), [](const char *path, unsigned int status_flags, void *payload) {
-      auto data = static_cast<Data *>(payload);
-
-      STATUS status;
-      if((status_flags & (GIT_STATUS_INDEX_NEW | GIT_STATUS_WT_NEW)) > 0)
-        status = STATUS::NEW;
-      else if((status_flags & (GIT_STATUS_INDEX_MODIFIED | GIT_STATUS_WT_MODIFIED)) > 0)
-        status = STATUS::MODIFIED;
-      else if((status_flags & (GIT_STATUS_INDEX_DELETED | GIT_STATUS_WT_DELETED)) > 0)
-        status = STATUS::DELETED;
-      else if((status_flags & (GIT_STATUS_INDEX_RENAMED | GIT_STATUS_WT_RENAMED)) > 0)
-        status = STATUS::RENAMED;
-      else if((status_flags & (GIT_STATUS_INDEX_TYPECHANGE | GIT_STATUS_WT_TYPECHANGE)) > 0)
-        status = STATUS::TYPECHANGE;
-      else if((status_flags & (GIT_STATUS_WT_UNREADABLE)) > 0)
-        status = STATUS::UNREADABLE;
-      else if((status_flags & (GIT_STATUS_IGNORED)) > 0)
-        status = STATUS::IGNORED;
-      else if((status_flags & (GIT_STATUS_CONFLICTED)) > 0)
-        status = STATUS::CONFLICTED;
-      else
-        status = STATUS::CURRENT;
-
-      boost::filesystem::path rel_path(path);
-      do {
-        if(status == STATUS::MODIFIED)
-          data->status.modified.emplace((data->work_path / rel_path).generic_string());
-        if(status == STATUS::NEW)
-          data->status.added.emplace((data->work_path / rel_path).generic_string());
-        rel_path = rel_path.parent_path();
-      } while(!rel_path.empty());
+    LockGuard saved_status_lock(saved_status_mutex);
+    full_update = !has_saved_status;
+    if(!full_update)
+      status = saved_status;
+    has_saved_status = true; // Set to false if the whole status is cleared during the update
+    paths = std::move(changed_paths);
+    changed_paths.clear();
+    read_index = index_changed;
+    index_changed = false;
+    updating_saved_status = true;
+  }
 
-      return 0;
-    }, &data);
+  auto now = std::chrono::steady_clock::now();
+  try {
+    if(read_index && !full_update) {
+      // Only the paths that changed in the index, and the paths that had a status, can have a different status
+      auto entries = read_index_entries();
+      for(auto &entry : entries) {
+        auto it = index_entries.find(entry.first);
+        if(it == index_entries.end() || !git_oid_equal(&it->second.id, &entry.second.id) || it->second.mode != entry.second.mode)
+          paths.emplace(entry.first);
+      }
+      for(auto &entry : index_entries) {
+        if(entries.find(entry.first) == entries.end())
+          paths.emplace(entry.first);
+      }
+      for(auto &file : status.files)
+        paths.emplace(file.first);
+      index_entries = std::move(entries);
+    }
+    if(paths.count(""))
+      full_update = true;
 
-    if(error)
-      throw std::runtime_error(error.message());
+    git_status_options options;
+    git_status_init_options(&options, GIT_STATUS_OPTIONS_VERSION);
+    options.flags = GIT_STATUS_OPT_INCLUDE_UNTRACKED | GIT_STATUS_OPT_RECURSE_UNTRACKED_DIRS | GIT_STATUS_OPT_DISABLE_PATHSPEC_MATCH;
+    std::vector<char *> pathspec;
+    if(full_update) {
+      status = Status();
+      status.work_path = work_path;
+      index_entries = read_index_entries();
+    }
+    else {
+      for(auto &path : paths) {
+        status.remove(path);
+        pathspec.emplace_back(const_cast<char *>(path.c_str()));
+      }
+      options.pathspec = {pathspec.data(), pathspec.size()};
+    }
+    if(full_update || !paths.empty()) {
+      error.code = git_status_foreach_ext(repository.get(), &options, add_status, &status);
+      if(error)
+        throw std::runtime_error(error.message());
+    }
+  }
+  catch(...) {
+    LockGuard saved_status_lock(saved_status_mutex);
+    has_saved_status = false;
+    updating_saved_status = false;
+    throw;
   }
 
-  LockGuard lock(saved_status_mutex);
-  saved_status = std::move(data.status);
-  has_saved_status = true;
+  LockGuard saved_status_lock(saved_status_mutex);
+  saved_status = std::move(status);
+  if(full_update)
+    full_update_time = now;
+  updating_saved_status = false;
   return saved_status;
 }
 
+int Git::Repository::add_status(const char *path, unsigned int status_flags, void *payload) {
+  auto status = static_cast<Status *>(payload);
+  if((status_flags & (GIT_STATUS_INDEX_NEW | GIT_STATUS_WT_NEW)) > 0)
+    status->add(path, STATUS::NEW);
+  else if((status_flags & (GIT_STATUS_INDEX_MODIFIED | GIT_STATUS_WT_MODIFIED)) > 0)
+    status->add(path, STATUS::MODIFIED);
+  return 0;
+}
+
+std::unordered_map<std::string, Git::Repository::IndexEntry> Git::Repository::read_index_entries() {
+  std::unordered_map<std::string, IndexEntry> entries;
+  git_index *index;
+  if(git_repository_index(&index, repository.get()) != 0)
+    return entries;
+  if(git_index_read(index, 0) == 0) {
+    auto count = git_index_entrycount(index);
+    entries.reserve(count);
+    for(size_t c = 0; c < count; ++c) {
+      auto entry = git_index_get_byindex(index, c);
+      auto pair = entries.emplace(entry->path, IndexEntry{entry->id, entry->mode});
+      if(!pair.second) // Conflicting entries
+        pair.first->second.mode = 0;
+    }
+  }
+  git_index_free(index);
+  return entries;
+}
+
 void Git::Repository::clear_saved_status() {
   LockGuard lock(saved_status_mutex);
-  saved_status = {};
   has_saved_status = false;
+  changed_paths.clear();
+}
+
+void Git::Repository::clear_saved_status(const boost::filesystem::path &path) {
+  // Use canonical path to follow symbolic links, and the canonical parent path if path was removed
+  boost::system::error_code ec;
+  auto canonical_path = boost::filesystem::canonical(path, ec);
+  if(ec)
+    canonical_path = boost::filesystem::canonical(path.parent_path(), ec) / path.filename();
+  if(!ec && filesystem::file_in_path(canonical_path, work_path)) {
+    auto relative_path = filesystem::get_relative_path(canonical_path, work_path);
+    if(!relative_path.empty() && *relative_path.begin() == ".git")
+      return;
+    LockGuard lock(saved_status_mutex);
+    changed_paths.emplace(relative_path.generic_string());
+  }
+  else
+    clear_saved_status();
+}
+
+bool Git::Repository::is_ignored(const std::string &path) noexcept {
+  int ignored = 0;
+  LockGuard lock(*mutex);
+  if(git_ignore_path_is_ignored(&ignored, repository.get(), path.c_str()) != 0)
+    return false;
+  return ignored == 1;
 }
 
 boost::filesystem::path Git::Repository::get_work_path() noexcept {
-  LockGuard lock(mutex);
+  LockGuard lock(*mutex);
   return Git::path(git_repository_workdir(repository.get()));
 }
 
 boost::filesystem::path Git::Repository::get_path() noexcept {
-  LockGuard lock(mutex);
+  LockGuard lock(*mutex);
   return Git::path(git_repository_path(repository.get()));
 }
 
 boost::filesystem::path Git::Repository::get_root_path(const boost::filesystem::path &path) {
   git_buf root = {nullptr, 0, 0};
-  LockGuard lock(mutex);
   initialize();
   error.code = git_repository_discover(&root, path.generic_string().c_str(), 0, nullptr);
   if(error)
@@ -216,13 +400,53 @@ boost::filesystem::path Git::Repository::get_root_path(const boost::filesystem::
 }
 
 Git::Repository::Diff Git::Repository::get_diff(const boost::filesystem::path &path) {
-  return Diff(path, repository.get());
+  auto relative_path = path.generic_string();
+  size_t id;
+  {
+    LockGuard lock(head_blobs_mutex);
+    auto it = head_blobs.find(relative_path);
+    if(it != head_blobs.end()) {
+      if(!it->second.blob)
+        throw std::runtime_error(it->second.error);
+      return Diff(it->second.blob, mutex);
+    }
+    id = head_blobs_id;
+  }
+
+  HeadBlob head_blob;
+  {
+    LockGuard lock(*mutex);
+    git_object *object;
+    error.code = git_revparse_single(&object, repository.get(), ("HEAD:" + relative_path).c_str());
+    if(error)
+      head_blob.error = error.message();
+    else {
+      head_blob.blob = std::shared_ptr<git_blob>(reinterpret_cast<git_blob *>(object), [](git_blob *blob) {
+        git_blob_free(blob);
+      });
+    }
+  }
+
+  {
+    LockGuard lock(head_blobs_mutex);
+    if(id == head_blobs_id)
+      head_blobs.emplace(relative_path, head_blob);
+  }
+  if(!head_blob.blob)
+    throw std::runtime_error(head_blob.error);
+  return Diff(std::move(head_blob.blob), mutex);
+}
+
+void Git::Repository::clear_head_blobs() {
+  LockGuard lock(head_blobs_mutex);
+  head_blobs.clear();
+  ++head_blobs_id;
 }
 
 std::string Git::Repository::get_branch() noexcept {
   std::string branch;
   git_reference *reference;
-  LockGuard lock(mutex);
+  LockGuard lock(*mutex);
   error.code = git_repository_head(&reference, repository.get());
   if(!error) {
     if(auto reference_name_cstr = git_reference_name(reference)) {
@@ -243,6 +467,7 @@ std::string Git::Repository::get_branch() noexcept {
 }
 
 void Git::initialize() noexcept {
+  LockGuard lock(initialized_mutex);
   if(!initialized) {
     git_libgit2_init();
     initialized = true;
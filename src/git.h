@@ -1,11 +1,14 @@
 #pragma once
 #include "mutex.h"
 #include <boost/filesystem.hpp>
+#include <chrono>
 #include <giomm.h>
 #include <git2.h>
 #include <iostream>
+#include <map>
 #include <memory>
-#include <unordered_set>
+#include <set>
+#include <unordered_map>
 #include <vector>
 
 class Git {
@@ -42,27 +45,58 @@ public:
 
     private:
       friend class Repository;
-      Diff(const boost::filesystem::path &path, git_repository *repository);
+      Diff(std::shared_ptr<git_blob> blob, std::shared_ptr<Mutex> mutex);
+      /// The mutex of the repository that owns blob
+      std::shared_ptr<Mutex> mutex;
       std::shared_ptr<git_blob> blob = nullptr;
       git_diff_options options;
 
     public:
       Lines get_lines(const std::string &buffer);
+      /// Returns the lines of the new buffer of the given hunks
+      static Lines get_lines(const std::vector<Hunk> &hunks);
+      /// Returns the HEAD version of the file
+      std::string get_old_buffer();
+      /// Diffs two buffers without a repository, and can therefore be called from any thread without locking
       static std::vector<Hunk> get_hunks(const std::string &old_buffer, const std::string &new_buffer);
       std::string get_details(const std::string &buffer, int line_nr);
     };
 
     enum class STATUS { CURRENT, NEW, MODIFIED, DELETED, RENAMED, TYPECHANGE, UNREADABLE, IGNORED, CONFLICTED };
+    /// New and modified files in the work tree, where a directory is new or modified if it contains such a file
     class Status {
+      friend class Repository;
+
+      class Node {
+      public:
+        size_t added = 0;
+        size_t modified = 0;
+        std::map<std::string, Node> children;
+      };
+
+      boost::filesystem::path work_path;
+      /// STATUS::NEW or STATUS::MODIFIED of the files, by path relative to the work path
+      std::map<std::string, STATUS> files;
+      /// Number of new and modified files in each directory, where the children are the path components
+      Node root;
+
+      void add(const std::string &path, STATUS status);
+      /// Removes the files at or below path
+      void remove(const std::string &path);
+      const Node *find(const boost::filesystem::path &path) const;
+
     public:
-      std::unordered_set<std::string> added;
-      std::unordered_set<std::string> modified;
+      bool is_added(const boost::filesystem::path &path) const;
+      bool is_modified(const boost::filesystem::path &path) const;
     };
 
   private:
     friend class Git;
     Repository(const boost::filesystem::path &path);
 
+    /// Mutex for the libgit2 calls on repository, and on the objects it owns.
+    /// Shared with the diffs of this repository.
+    std::shared_ptr<Mutex> mutex;
     std::unique_ptr<git_repository, std::function<void(git_repository *)>> repository;
 
     boost::filesystem::path work_path;
@@ -70,36 +104,77 @@ public:
     Mutex saved_status_mutex;
     Status saved_status GUARDED_BY(saved_status_mutex);
     bool has_saved_status GUARDED_BY(saved_status_mutex) = false;
+    /// Paths relative to the work path whose status has to be read again before saved_status can be used
+    std::set<std::string> changed_paths GUARDED_BY(saved_status_mutex);
+    bool index_changed GUARDED_BY(saved_status_mutex) = false;
+    bool updating_saved_status GUARDED_BY(saved_status_mutex) = false;
+    /// Changes that are not reported, for instance in directories that are not monitored,
+    /// are found when the whole status is read again at most full_update_interval after the last full read
+    std::chrono::steady_clock::time_point full_update_time GUARDED_BY(saved_status_mutex);
+    std::chrono::steady_clock::duration full_update_interval = std::chrono::seconds(30);
+
+    class IndexEntry {
+    public:
+      git_oid id;
+      uint32_t mode;
+    };
+    /// Index entries when saved_status was last updated, only used while mutex is locked
+    std::unordered_map<std::string, IndexEntry> index_entries;
+    std::unordered_map<std::string, IndexEntry> read_index_entries();
+
+    static int add_status(const char *path, unsigned int status_flags, void *payload);
+
+    class HeadBlob {
+    public:
+      std::shared_ptr<git_blob> blob;
+      /// Set if the path could not be found in HEAD
+      std::string error;
+    };
+    Mutex head_blobs_mutex;
+    /// Blobs of the files in HEAD by path relative to the work path, shared by the diffs of the files,
+    /// and cleared when HEAD or the index changes
+    std::unordered_map<std::string, HeadBlob> head_blobs GUARDED_BY(head_blobs_mutex);
+    /// Incremented when head_blobs is cleared, so that blobs read before that are not added
+    size_t head_blobs_id GUARDED_BY(head_blobs_mutex) = 0;
+    void clear_head_blobs();
 
   public:
     ~Repository();
 
+    /// Returns the saved status, where only the changed paths are read again if the whole status has been read
+    /// less than full_update_interval ago
     Status get_status();
+    /// The whole status is read again on next get_status
     void clear_saved_status();
+    /// The status of path, a file or directory, is read again on next get_status
+    void clear_saved_status(const boost::filesystem::path &path);
 
     boost::filesystem::path get_work_path() noexcept;
     boost::filesystem::path get_path() noexcept;
     static boost::filesystem::path get_root_path(const boost::filesystem::path &path);
 
+    /// Returns the diff between the HEAD version of path, relative to the work path, and a buffer
     Diff get_diff(const boost::filesystem::path &path);
 
+    /// Returns true if path, relative to the work path, is ignored by .gitignore or similar rules
+    bool is_ignored(const std::string &path) noexcept;
+
     std::string get_branch() noexcept;
 
     Glib::RefPtr<Gio::FileMonitor> monitor;
   };
 
 private:
-  static bool initialized GUARDED_BY(mutex);
-
-  ///Mutex for thread safe operations
-  static Mutex mutex;
+  static Mutex initialized_mutex;
+  static bool initialized GUARDED_BY(initialized_mutex);
 
-  static Error error GUARDED_BY(mutex);
+  /// Error of the last libgit2 call in the current thread
+  static thread_local Error error;
 
   ///Call initialize in public static methods
-  static void initialize() noexcept REQUIRES(mutex);
+  static void initialize() noexcept;
 
-  static boost::filesystem::path path(const char *cpath, size_t cpath_length = static_cast<size_t>(-1)) noexcept REQUIRES(mutex);
+  static boost::filesystem::path path(const char *cpath, size_t cpath_length = static_cast<size_t>(-1)) noexcept;
 
 public:
   static std::shared_ptr<Repository> get_repository(const boost::filesystem::path &path);
@@ -0,0 +1,231 @@
+#include "grep.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <thread>
+#ifdef _WIN32
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+Grep::Grep(const std::string &pattern, bool case_sensitive, bool regex) : case_sensitive(case_sensitive) {
+  if(regex) {
+    auto flags = std::regex::ECMAScript | std::regex::optimize;
+    if(!case_sensitive)
+      flags |= std::regex::icase;
+    this->regex = std::make_unique<std::regex>(pattern, flags);
+    literal = get_required_literal(pattern);
+  }
+  else
+    literal = pattern;
+  if(!case_sensitive)
+    std::transform(literal.begin(), literal.end(), literal.begin(), ::tolower);
+}
+
+void Grep::search(const boost::filesystem::path &path, const std::vector<std::string> &files, const std::atomic<bool> &canceled,
+                  const std::function<void(std::vector<Location> &&locations)> &on_locations) const {
+  std::atomic<size_t> next(0);
+  auto worker = [&] {
+    size_t c;
+    while(!canceled && (c = next++) < files.size()) {
+      auto locations = search_file(path / files[c]);
+      if(!locations.empty()) {
+        for(auto &location : locations)
+          location.file_path = files[c];
+        on_locations(std::move(locations));
+      }
+    }
+  };
+  auto thread_count = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u), files.size());
+  std::vector<std::thread> threads;
+  for(size_t c = 1; c < thread_count; ++c)
+    threads.emplace_back(worker);
+  worker();
+  for(auto &thread : threads)
+    thread.join();
+}
+
+std::vector<Grep::Location> Grep::search(const char *buffer, size_t size) const {
+  std::vector<Location> locations;
+  if(!regex && literal.empty())
+    return locations;
+
+  auto end = buffer + size;
+  auto line_start = buffer;
+  unsigned long line = 0;
+  while(line_start < end) {
+    auto found = find_literal(line_start, end);
+    if(!found)
+      break;
+
+    // Move to the start of the line containing found
+    auto found_line_start = found;
+    while(found_line_start > line_start && *(found_line_start - 1) != '\n')
+      --found_line_start;
+    line += std::count(line_start, found_line_start, '\n');
+    line_start = found_line_start;
+    auto line_end = static_cast<const char *>(std::memchr(found, '\n', end - found));
+    if(!line_end)
+      line_end = end;
+    auto source_end = line_end > line_start && *(line_end - 1) == '\r' ? line_end - 1 : line_end;
+
+    if(regex) {
+      std::cmatch match;
+      if(std::regex_search(line_start, source_end, match, *regex))
+        locations.emplace_back(Location{{}, line, static_cast<unsigned long>(match.position(0)), static_cast<unsigned long>(match.length(0)), std::string(line_start, source_end)});
+    }
+    else
+      locations.emplace_back(Location{{}, line, static_cast<unsigned long>(found - line_start), literal.size(), std::string(line_start, source_end)});
+
+    if(line_end == end)
+      break;
+    line_start = line_end + 1;
+    ++line;
+  }
+  return locations;
+}
+
+std::string Grep::get_required_literal(const std::string &pattern) {
+  if(pattern.find('|') != std::string::npos)
+    return std::string();
+
+  std::string longest, current;
+  auto end_current = [&longest, &current] {
+    if(current.size() > longest.size())
+      longest = current;
+    current.clear();
+  };
+  // Only characters outside of groups are used, since a group can be optional
+  int group_depth = 0;
+  for(size_t c = 0; c < pattern.size(); ++c) {
+    auto chr = pattern[c];
+    if(chr == '\\') {
+      end_current();
+      ++c;
+    }
+    else if(chr == '[') {
+      end_current();
+      ++c;
+      if(c < pattern.size() && pattern[c] == '^')
+        ++c;
+      if(c < pattern.size() && pattern[c] == ']')
+        ++c;
+      for(; c < pattern.size() && pattern[c] != ']'; ++c) {
+        if(pattern[c] == '\\')
+          ++c;
+      }
+    }
+    else if(chr == '?' || chr == '*' || chr == '{') {
+      // The previous character is optional
+      if(!current.empty())
+        current.pop_back();
+      end_current();
+      if(chr == '{') {
+        while(c < pattern.size() && pattern[c] != '}')
+          ++c;
+      }
+    }
+    else if(chr == '(') {
+      end_current();
+      ++group_depth;
+    }
+    else if(chr == ')')
+      --group_depth;
+    else if(chr == '+' || chr == '^' || chr == '$' || chr == '.')
+      end_current();
+    else if(group_depth == 0)
+      current += chr;
+  }
+  end_current();
+  return longest;
+}
+
+const char *Grep::find_literal(const char *begin, const char *end) const {
+  if(literal.empty())
+    return begin;
+  if(static_cast<size_t>(end - begin) < literal.size())
+    return nullptr;
+
+  auto matches_rest = [this](const char *pos) {
+    if(case_sensitive)
+      return std::memcmp(pos + 1, literal.data() + 1, literal.size() - 1) == 0;
+    for(size_t c = 1; c < literal.size(); ++c) {
+      if(std::tolower(static_cast<unsigned char>(pos[c])) != static_cast<unsigned char>(literal[c]))
+        return false;
+    }
+    return true;
+  };
+
+  // Candidates are found with memchr on the first character, and in both cases if not case sensitive
+  auto last = end - literal.size() + 1;
+  auto first = literal[0];
+  auto first_upper = static_cast<char>(std::toupper(static_cast<unsigned char>(first)));
+  auto find = [last](const char *pos, char chr) {
+    return static_cast<const char *>(std::memchr(pos, chr, last - pos));
+  };
+  if(case_sensitive || first_upper == first) {
+    for(auto pos = find(begin, first); pos; pos = find(pos + 1, first)) {
+      if(matches_rest(pos))
+        return pos;
+    }
+  }
+  else {
+    auto lower_pos = find(begin, first);
+    auto upper_pos = find(begin, first_upper);
+    while(lower_pos || upper_pos) {
+      const char *pos;
+      if(lower_pos && (!upper_pos || lower_pos < upper_pos)) {
+        pos = lower_pos;
+        lower_pos = find(pos + 1, first);
+      }
+      else {
+        pos = upper_pos;
+        upper_pos = find(pos + 1, first_upper);
+      }
+      if(matches_rest(pos))
+        return pos;
+    }
+  }
+  return nullptr;
+}
+
+std::vector<Grep::Location> Grep::search_file(const boost::filesystem::path &path) const {
+  // Files with a null character in the beginning are assumed to be binary, and are not searched
+  auto is_binary = [](const char *buffer, size_t size) {
+    return std::memchr(buffer, '\0', std::min<size_t>(size, 8192)) != nullptr;
+  };
+#ifdef _WIN32
+  std::ifstream stream(path.string(), std::ifstream::binary);
+  if(!stream)
+    return {};
+  std::string buffer;
+  buffer.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+  if(buffer.empty() || is_binary(buffer.data(), buffer.size()))
+    return {};
+  return search(buffer.data(), buffer.size());
+#else
+  auto fd = open(path.string().c_str(), O_RDONLY);
+  if(fd < 0)
+    return {};
+  struct stat st;
+  if(fstat(fd, &st) != 0 || st.st_size == 0) {
+    close(fd);
+    return {};
+  }
+  size_t size = st.st_size;
+  auto data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if(data == MAP_FAILED)
+    return {};
+  auto buffer = static_cast<const char *>(data);
+  std::vector<Location> locations;
+  if(!is_binary(buffer, size))
+    locations = search(buffer, size);
+  munmap(data, size);
+  return locations;
+#endif
+}
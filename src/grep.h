@@ -0,0 +1,51 @@
+#pragma once
+#include <atomic>
+#include <boost/filesystem.hpp>
+#include <functional>
+#include <memory>
+#include <regex>
+#include <string>
+#include <vector>
+
+/// Searches files for a literal string or a regular expression, one match per line
+class Grep {
+public:
+  class Location {
+  public:
+    /// Empty for buffer searches, otherwise relative to the searched path
+    std::string file_path;
+    unsigned long line;
+    unsigned long index;
+    unsigned long length;
+    /// The line of the match, without line ending
+    std::string source;
+  };
+
+  /// Throws std::regex_error if regex is true and pattern is not a valid regular expression
+  Grep(const std::string &pattern, bool case_sensitive, bool regex);
+
+  /// Searches the files, relative to path, using one thread per core.
+  /// on_locations is called from the search threads with the locations of each file that has matches.
+  /// Returns early if canceled is set to true.
+  void search(const boost::filesystem::path &path, const std::vector<std::string> &files, const std::atomic<bool> &canceled,
+              const std::function<void(std::vector<Location> &&locations)> &on_locations) const;
+
+  /// Returns the locations in buffer, where at most one location is returned per line
+  std::vector<Location> search(const char *buffer, size_t size) const;
+
+  /// Returns a string that all matches contain, lowercase if not case sensitive, or an empty string if none was found
+  const std::string &get_literal() const { return literal; }
+
+private:
+  bool case_sensitive;
+  std::unique_ptr<std::regex> regex;
+  /// String that all matches contain, lowercase if not case_sensitive.
+  /// Used to find candidate lines with memchr before trying the regex. Empty if no such string was found.
+  std::string literal;
+
+  /// Returns the longest string that all matches of the regular expression pattern must contain
+  static std::string get_required_literal(const std::string &pattern);
+  /// Returns the first occurrence of literal in [begin, end), or nullptr if not found
+  const char *find_literal(const char *begin, const char *end) const;
+  std::vector<Location> search_file(const boost::filesystem::path &path) const;
+};
@@ -49,7 +49,8 @@ int Application::on_command_line(const Glib::RefPtr<Gio::ApplicationCommandLine>
 void Application::on_activate() {
   std::vector<std::pair<int, int>> file_offsets;
   std::string current_file;
-  Window::get().load_session(directories, files, file_offsets, current_file, directories.empty() && files.empty());
+  bool restore_session = directories.empty() && files.empty();
+  Window::get().load_session(directories, files, file_offsets, current_file, restore_session);
 
   Window::get().add_widgets();
 
@@ -81,10 +82,15 @@ void Application::on_activate() {
     }
   }
 
+  auto restored_tabs_parsed_at_startup = Config::get().source.restored_tabs_parsed_at_startup;
   for(size_t i = 0; i < files.size(); ++i) {
-    Notebook::get().open(files[i].first, files[i].second);
+    // Only the most recently opened tabs of the last session are parsed at startup
+    bool delay_parse = restore_session && restored_tabs_parsed_at_startup >= 0 && i + static_cast<size_t>(restored_tabs_parsed_at_startup) < files.size();
+    auto size = Notebook::get().size();
+    Notebook::get().open(files[i].first, files[i].second, delay_parse);
     if(i < file_offsets.size()) {
-      if(auto view = Notebook::get().get_current_view()) {
+      auto view = delay_parse ? Notebook::get().get_view(size) : Notebook::get().get_current_view();
+      if(view) {
         view->place_cursor_at_line_offset(file_offsets[i].first, file_offsets[i].second);
         view->hide_tooltips();
       }
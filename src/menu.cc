@@ -226,6 +226,10 @@ const Glib::ustring menu_xml = R"RAW(<interface>
           <attribute name='label' translatable='yes'>_Find</attribute>
           <attribute name='action'>app.edit_find</attribute>
         </item>
+        <item>
+          <attribute name='label' translatable='yes'>_Find _in _Project</attribute>
+          <attribute name='action'>app.edit_find_in_project</attribute>
+        </item>
       </section>
     </submenu>
 
@@ -384,6 +388,16 @@ const Glib::ustring menu_xml = R"RAW(<interface>
           <attribute name='action'>app.project_recreate_build</attribute>
         </item>
       </section>
+      <section>
+        <item>
+          <attribute name='label' translatable='yes'>_Go _to _Next _Build _Error</attribute>
+          <attribute name='action'>app.project_goto_next_build_error</attribute>
+        </item>
+        <item>
+          <attribute name='label' translatable='yes'>_Go _to _Previous _Build _Error</attribute>
+          <attribute name='action'>app.project_goto_previous_build_error</attribute>
+        </item>
+      </section>
       <section>
         <item>
           <attribute name='label' translatable='yes'>_Run _Command</attribute>
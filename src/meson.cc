@@ -88,11 +88,11 @@ bool Meson::update_debug_build(const boost::filesystem::path &debug_build_path,
 }
 
 boost::filesystem::path Meson::get_executable(const boost::filesystem::path &build_path, const boost::filesystem::path &file_path) {
-  CompileCommands compile_commands(build_path);
+  auto compile_commands = CompileCommands::get(build_path);
 
   size_t best_match_size = -1;
   boost::filesystem::path best_match_executable;
-  for(auto &command : compile_commands.commands) {
+  for(auto &command : compile_commands->commands) {
     auto command_file = filesystem::get_normal_path(command.file);
     auto values = command.parameter_values("-o");
     if(!values.empty()) {
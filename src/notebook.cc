@@ -56,6 +56,8 @@ Notebook::Notebook() : Gtk::Paned(), notebooks(2) {
       last_index = -1;
     });
     notebook.signal_page_added().connect([this](Gtk::Widget *widget, guint) {
+      if(adding_background_page)
+        return;
       auto hbox = dynamic_cast<Gtk::Box *>(widget);
       for(size_t c = 0; c < hboxes.size(); ++c) {
         if(hboxes[c].get() == hbox) {
@@ -103,7 +105,7 @@ std::vector<Source::View *> &Notebook::get_views() {
   return source_views;
 }
 
-void Notebook::open(const boost::filesystem::path &file_path_, size_t notebook_index) {
+void Notebook::open(const boost::filesystem::path &file_path_, size_t notebook_index, bool delay_parse) {
   auto file_path = filesystem::get_normal_path(file_path_);
 
   if(notebook_index == 1 && !split)
@@ -153,9 +155,9 @@ void Notebook::open(const boost::filesystem::path &file_path_, size_t notebook_i
   }
 
   if(language && (language->get_id() == "chdr" || language->get_id() == "cpphdr" || language->get_id() == "c" || language->get_id() == "cpp" || language->get_id() == "objc"))
-    source_views.emplace_back(new Source::ClangView(file_path, language));
+    source_views.emplace_back(new Source::ClangView(file_path, language, delay_parse));
   else if(language && !language_protocol_language_id.empty() && !filesystem::find_executable(language_protocol_language_id + "-language-server").empty())
-    source_views.emplace_back(new Source::LanguageProtocolView(file_path, language, language_protocol_language_id));
+    source_views.emplace_back(new Source::LanguageProtocolView(file_path, language, language_protocol_language_id, delay_parse));
   else
     source_views.emplace_back(new Source::GenericView(file_path, language));
 
@@ -293,6 +295,11 @@ void Notebook::open(const boost::filesystem::path &file_path_, size_t notebook_i
 
   configure(source_views.size() - 1);
 
+  for(auto &diagnostic : Terminal::get().build_diagnostics.diagnostics) {
+    if(diagnostic.path == file_path.string())
+      view->add_build_diagnostic_mark(static_cast<int>(diagnostic.line) - 1, diagnostic.severity == BuildDiagnostics::Diagnostic::Severity::ERROR);
+  }
+
   //Set up tab label
   tab_labels.emplace_back(new TabLabel([this, view]() {
     auto index = get_index(view);
@@ -427,12 +434,19 @@ void Notebook::open(const boost::filesystem::path &file_path_, size_t notebook_i
   }
   auto &notebook = notebooks[notebook_index];
 
+  // The page of a background tab is not shown unless the notebook is empty
+  adding_background_page = delay_parse && notebook.get_n_pages() > 0;
   notebook.append_page(*hboxes.back(), *tab_labels.back());
+  bool background_page = adding_background_page;
+  adding_background_page = false;
 
   notebook.set_tab_reorderable(*hboxes.back(), true);
   notebook.set_tab_detachable(*hboxes.back(), true);
   show_all_children();
 
+  if(background_page)
+    return;
+
   notebook.set_current_page(notebook.get_n_pages() - 1);
   last_index = -1;
   if(last_view) {
@@ -34,7 +34,9 @@ public:
   Source::View *get_current_view();
   std::vector<Source::View *> &get_views();
 
-  void open(const boost::filesystem::path &file_path, size_t notebook_index = -1);
+  /// If delay_parse is true, the file is opened in a background tab, and parsing
+  /// or language server notifications are postponed until the tab is first shown.
+  void open(const boost::filesystem::path &file_path, size_t notebook_index = -1, bool delay_parse = false);
   void open_uri(const std::string &uri);
   void configure(size_t index);
   bool save(size_t index);
@@ -81,6 +83,8 @@ private:
 
   bool split = false;
   size_t last_index = -1;
+  /// Set while a background tab is added, to avoid focusing it
+  bool adding_background_page = false;
 
   void set_current_view(Source::View *view);
   Source::View *current_view = nullptr;
@@ -17,7 +17,10 @@
 #include "source_clang.h"
 #include "source_language_protocol.h"
 #include "usages_clang.h"
+#include <atomic>
 #include <future>
+#include <sstream>
+#include <thread>
 
 boost::filesystem::path Project::debug_last_stop_file_path;
 std::unordered_map<std::string, std::string> Project::run_arguments;
@@ -89,6 +92,12 @@ void Project::on_save(size_t index) {
   }
 }
 
+void Project::clear_build_diagnostics() {
+  Terminal::get().build_diagnostics.clear();
+  for(auto view : Notebook::get().get_views())
+    view->clear_build_diagnostic_marks();
+}
+
 void Project::debug_update_status(const std::string &new_debug_status) {
   debug_status = new_debug_status;
   if(debug_status.empty())
@@ -205,52 +214,99 @@ void Project::Base::show_symbols() {
       return;
     }
   }
-  auto pair = Ctags::get_result(search_path);
 
-  auto path = std::move(pair.first);
-  auto stream = std::move(pair.second);
-  stream->seekg(0, std::ios::end);
-  if(stream->tellg() == 0) {
-    Info::get().print("No symbols found in current project");
-    return;
-  }
-  stream->seekg(0, std::ios::beg);
+  // Ctags runs in a separate thread, and the symbols are added to the dialog in batches
+  auto canceled = std::make_shared<std::atomic<bool>>(false);
+  std::thread([self = shared_from_this(), search_path = std::move(search_path), canceled] {
+    auto pair = Ctags::get_result(search_path);
+    auto path = std::make_shared<boost::filesystem::path>(std::move(pair.first));
+    auto &lines = *pair.second;
+    if(lines.empty()) {
+      self->dispatcher.post([] {
+        Info::get().print("No symbols found in current project");
+      });
+      return;
+    }
 
-  if(view) {
-    auto dialog_iter = view->get_iter_for_dialog();
-    SelectionDialog::create(view, view->get_buffer()->create_mark(dialog_iter), true, true);
-  }
-  else
-    SelectionDialog::create(true, true);
+    auto rows = std::make_shared<std::vector<Source::Offset>>();
+    auto dialog = std::make_shared<SelectionDialog *>(nullptr);
+    const size_t batch_size = 1000;
+    std::future<void> previous_batch_added;
+    for(size_t start = 0; start < lines.size() && !*canceled; start += batch_size) {
+      auto end = std::min(start + batch_size, lines.size());
+      std::vector<std::pair<Source::Offset, std::string>> batch;
+      batch.reserve(end - start);
+      for(auto c = start; c < end; ++c) {
+        auto location = Ctags::get_location(lines[c], true);
+        std::string row = location.file_path.string() + ":" + std::to_string(location.line + 1) + ": " + location.source;
+        batch.emplace_back(Source::Offset(location.line, location.index, location.file_path), std::move(row));
+      }
 
-  std::vector<Source::Offset> rows;
+      // The next batch is posted after the previous batch is added, so that the batches are added in separate main loop iterations
+      if(previous_batch_added.valid()) {
+        try {
+          previous_batch_added.get();
+        }
+        catch(...) { // The previous batch was discarded
+          return;
+        }
+        if(*canceled)
+          return;
+      }
+      auto batch_added = std::make_shared<std::promise<void>>();
+      previous_batch_added = batch_added->get_future();
 
-  std::string line;
-  while(std::getline(*stream, line)) {
-    auto location = Ctags::get_location(line, true);
+      self->dispatcher.post([batch = std::move(batch), first_batch = start == 0, path, rows, dialog, canceled, batch_added] {
+        if(*canceled) {
+          batch_added->set_value();
+          return;
+        }
+        auto view = Notebook::get().get_current_view();
+        if(first_batch) {
+          if(view) {
+            auto dialog_iter = view->get_iter_for_dialog();
+            SelectionDialog::create(view, view->get_buffer()->create_mark(dialog_iter), true, true);
+          }
+          else
+            SelectionDialog::create(true, true);
+          *dialog = SelectionDialog::get().get();
+
+          SelectionDialog::get()->on_hide = [canceled] {
+            *canceled = true;
+          };
+          SelectionDialog::get()->on_select = [rows, path](unsigned int index, const std::string &text, bool hide_window) {
+            if(index >= rows->size())
+              return;
+            auto offset = (*rows)[index];
+            auto full_path = *path / offset.file_path;
+            if(!boost::filesystem::is_regular_file(full_path))
+              return;
+            Notebook::get().open(full_path);
+            auto view = Notebook::get().get_current_view();
+            view->place_cursor_at_line_index(offset.line, offset.index);
+            view->scroll_to_cursor_delayed(view, true, false);
+          };
+        }
+        else if(SelectionDialog::get().get() != *dialog) { // Another dialog has replaced the symbols dialog
+          *canceled = true;
+          batch_added->set_value();
+          return;
+        }
 
-    std::string row = location.file_path.string() + ":" + std::to_string(location.line + 1) + ": " + location.source;
-    rows.emplace_back(Source::Offset(location.line, location.index, location.file_path));
-    SelectionDialog::get()->add_row(row);
-  }
+        for(auto &row : batch) {
+          rows->emplace_back(std::move(row.first));
+          SelectionDialog::get()->add_row(row.second);
+        }
 
-  if(rows.size() == 0)
-    return;
-  SelectionDialog::get()->on_select = [rows = std::move(rows), path = std::move(path)](unsigned int index, const std::string &text, bool hide_window) {
-    if(index >= rows.size())
-      return;
-    auto offset = rows[index];
-    auto full_path = path / offset.file_path;
-    if(!boost::filesystem::is_regular_file(full_path))
-      return;
-    Notebook::get().open(full_path);
-    auto view = Notebook::get().get_current_view();
-    view->place_cursor_at_line_index(offset.line, offset.index);
-    view->scroll_to_cursor_delayed(view, true, false);
-  };
-  if(view)
-    view->hide_tooltips();
-  SelectionDialog::get()->show();
+        if(first_batch) {
+          if(view)
+            view->hide_tooltips();
+          SelectionDialog::get()->show();
+        }
+        batch_added->set_value();
+      });
+    }
+  }).detach();
 }
 
 std::pair<std::string, std::string> Project::Base::debug_get_run_arguments() {
@@ -823,6 +879,7 @@ void Project::Clang::compile() {
     return;
 
   compiling = true;
+  clear_build_diagnostics();
 
   if(Config::get().project.clear_terminal_on_compile)
     Terminal::get().clear();
@@ -857,6 +914,7 @@ void Project::Clang::compile_and_run() {
   }
 
   compiling = true;
+  clear_build_diagnostics();
 
   if(Config::get().project.clear_terminal_on_compile)
     Terminal::get().clear();
@@ -1035,6 +1093,7 @@ std::pair<std::string, std::string> Project::Rust::get_run_arguments() {
 
 void Project::Rust::compile() {
   compiling = true;
+  clear_build_diagnostics();
 
   if(Config::get().project.clear_terminal_on_compile)
     Terminal::get().clear();
@@ -1049,6 +1108,7 @@ void Project::Rust::compile() {
 
 void Project::Rust::compile_and_run() {
   compiling = true;
+  clear_build_diagnostics();
 
   if(Config::get().project.clear_terminal_on_compile)
     Terminal::get().clear();
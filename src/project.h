@@ -25,6 +25,8 @@ namespace Project {
   Gtk::Label &debug_status_label();
   void save_files(const boost::filesystem::path &path);
   void on_save(size_t index);
+  /// Clears the build errors and warnings, and their marks in the open views
+  void clear_build_diagnostics();
 
   extern boost::filesystem::path debug_last_stop_file_path;
   extern std::unordered_map<std::string, std::string> run_arguments;
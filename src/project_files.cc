@@ -0,0 +1,163 @@
+#include "project_files.h"
+#include "filesystem.h"
+#include "project_build.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+Mutex ProjectFiles::caches_mutex;
+std::map<boost::filesystem::path, ProjectFiles::Cache> ProjectFiles::caches;
+
+ProjectFiles::Paths ProjectFiles::get_paths(const boost::filesystem::path &path) {
+  Paths paths;
+  auto build = Project::Build::create(path);
+  paths.project_path = build->project_path;
+  if(!paths.project_path.empty()) {
+    paths.build_path = build->get_default_path();
+    paths.debug_path = build->get_debug_path();
+  }
+  else {
+    boost::system::error_code ec;
+    if(boost::filesystem::is_directory(path, ec) || ec)
+      paths.project_path = path;
+    else
+      paths.project_path = path.parent_path();
+  }
+  return paths;
+}
+
+std::pair<boost::filesystem::path, std::shared_ptr<const std::vector<std::string>>> ProjectFiles::get_files(const boost::filesystem::path &path) {
+  auto paths = get_paths(path);
+  return {paths.project_path, get_files(paths.project_path, paths.build_path, paths.debug_path)};
+}
+
+std::shared_ptr<const std::vector<std::string>> ProjectFiles::get_files(const boost::filesystem::path &project_path,
+                                                                        const boost::filesystem::path &build_path, const boost::filesystem::path &debug_path) {
+  LockGuard lock(caches_mutex);
+  auto &project = caches[project_path];
+  if(!project.files || project.build_path != build_path || project.debug_path != debug_path) {
+    project.build_path = build_path;
+    project.debug_path = debug_path;
+    project.directories.clear();
+    project.files.reset();
+    project.repository.reset();
+    project.repository_prefix.clear();
+    try {
+      auto repository = Git::get_repository(project_path);
+      auto work_path = repository->get_work_path();
+      if(filesystem::file_in_path(project_path, work_path)) {
+        project.repository = std::move(repository);
+        auto prefix = filesystem::get_relative_path(project_path, work_path).generic_string();
+        if(!prefix.empty() && prefix != ".")
+          project.repository_prefix = prefix + '/';
+      }
+    }
+    catch(const std::exception &) {
+    }
+  }
+
+  if(update(project_path, project) || !project.files) {
+    auto files = std::make_shared<std::vector<std::string>>();
+    for(auto &directory : project.directories) {
+      for(auto &file : directory.second.files)
+        files->emplace_back(directory.first.empty() ? file : directory.first + '/' + file);
+    }
+    std::sort(files->begin(), files->end());
+    project.files = std::move(files);
+  }
+  return project.files;
+}
+
+bool ProjectFiles::update(const boost::filesystem::path &project_path, Cache &project) {
+  bool full_update = project.directories.empty();
+  std::atomic<bool> changed(false);
+  std::atomic<bool> gitignore_changed(false);
+  std::atomic<size_t> reused_count(0);
+
+  auto now = std::time(nullptr);
+  std::map<std::string, Directory> directories;
+  std::vector<std::string> level = {""};
+  while(!level.empty()) {
+    // Each thread takes the next directory of the current level until all are done
+    std::vector<std::unique_ptr<Directory>> results(level.size());
+    std::atomic<size_t> next(0);
+    auto worker = [&] {
+      size_t c;
+      while((c = next++) < level.size()) {
+        auto path = level[c].empty() ? project_path : project_path / level[c];
+        boost::system::error_code ec;
+        auto last_write_time = boost::filesystem::last_write_time(path, ec);
+        if(ec)
+          continue;
+        auto gitignore_last_write_time = boost::filesystem::last_write_time(path / ".gitignore", ec);
+        if(ec)
+          gitignore_last_write_time = 0;
+
+        auto it = project.directories.find(level[c]);
+        if(it != project.directories.end() && it->second.last_write_time == last_write_time && it->second.gitignore_last_write_time == gitignore_last_write_time) {
+          results[c] = std::make_unique<Directory>(std::move(it->second));
+          ++reused_count;
+          continue;
+        }
+        if(it != project.directories.end() && it->second.gitignore_last_write_time != gitignore_last_write_time)
+          gitignore_changed = true;
+        results[c] = std::make_unique<Directory>(Directory{filesystem::get_stable_last_write_time(last_write_time, now), gitignore_last_write_time, {}, {}});
+        list_directory(project_path, project, level[c], *results[c]);
+        changed = true;
+      }
+    };
+    auto thread_count = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u), level.size());
+    std::vector<std::thread> threads;
+    for(size_t c = 1; c < thread_count; ++c)
+      threads.emplace_back(worker);
+    worker();
+    for(auto &thread : threads)
+      thread.join();
+
+    std::vector<std::string> next_level;
+    for(size_t c = 0; c < level.size(); ++c) {
+      if(!results[c])
+        continue;
+      for(auto &directory : results[c]->directories)
+        next_level.emplace_back(level[c].empty() ? directory : level[c] + '/' + directory);
+      directories.emplace(std::move(level[c]), std::move(*results[c]));
+    }
+    level = std::move(next_level);
+  }
+
+  if(reused_count != project.directories.size())
+    changed = true; // Directories were removed
+  project.directories = std::move(directories);
+
+  // A changed .gitignore file can affect the subdirectories that were not listed again
+  if(gitignore_changed && !full_update) {
+    project.directories.clear();
+    update(project_path, project);
+  }
+  return changed;
+}
+
+void ProjectFiles::list_directory(const boost::filesystem::path &project_path, const Cache &project, const std::string &relative_path, Directory &directory) {
+  auto path = relative_path.empty() ? project_path : project_path / relative_path;
+  boost::system::error_code ec;
+  for(boost::filesystem::directory_iterator it(path, ec), end; it != end; it.increment(ec)) {
+    if(ec)
+      break;
+    auto &entry_path = it->path();
+    auto filename = entry_path.filename().string();
+    auto is_ignored = [&] {
+      return project.repository && project.repository->is_ignored(project.repository_prefix + (relative_path.empty() ? filename : relative_path + '/' + filename));
+    };
+    // Symbolic links to directories are not followed, similar to boost::filesystem::recursive_directory_iterator
+    auto status = it->symlink_status(ec);
+    if(ec)
+      continue;
+    if(boost::filesystem::is_directory(status)) {
+      if(filename == ".git" || entry_path == project.build_path || entry_path == project.debug_path || is_ignored())
+        continue;
+      directory.directories.emplace_back(std::move(filename));
+    }
+    else if(boost::filesystem::is_regular_file(it->status(ec)) && !ec && !is_ignored())
+      directory.files.emplace_back(std::move(filename));
+  }
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include "git.h"
+#include "mutex.h"
+#include <boost/filesystem.hpp>
+#include <ctime>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+/// Cached list of the files in a project, shared by Find File, usages and ctags.
+/// The first call walks the project directories in parallel. Later calls only list
+/// directories whose last write time has changed since the previous call.
+class ProjectFiles {
+public:
+  class Paths {
+  public:
+    boost::filesystem::path project_path, build_path, debug_path;
+  };
+
+  /// Returns the project path of path, and its build paths if any.
+  /// If path is not in a project, the project path is path, or the parent directory of path.
+  static Paths get_paths(const boost::filesystem::path &path);
+
+  /// Returns the project path of path, and the regular files in the project relative to the project path, sorted.
+  /// If path is not in a project, the files in path, or the parent directory of path, are returned.
+  static std::pair<boost::filesystem::path, std::shared_ptr<const std::vector<std::string>>> get_files(const boost::filesystem::path &path);
+
+  /// Returns the regular files in project_path, relative to project_path, sorted.
+  /// Files in build_path, debug_path, .git directories, and files ignored by git, are excluded.
+  static std::shared_ptr<const std::vector<std::string>> get_files(const boost::filesystem::path &project_path,
+                                                                   const boost::filesystem::path &build_path, const boost::filesystem::path &debug_path);
+
+private:
+  class Directory {
+  public:
+    std::time_t last_write_time;
+    /// Last write time of the .gitignore file in the directory, 0 if not found
+    std::time_t gitignore_last_write_time;
+    /// Subdirectory and file names that are not excluded
+    std::vector<std::string> directories, files;
+  };
+
+  class Cache {
+  public:
+    boost::filesystem::path build_path, debug_path;
+    std::shared_ptr<Git::Repository> repository;
+    /// Relative path from the git work path to the project path, with a trailing / if not empty
+    std::string repository_prefix;
+    /// Directories by path relative to the project path, where the project path is ""
+    std::map<std::string, Directory> directories;
+    std::shared_ptr<const std::vector<std::string>> files;
+  };
+
+  static Mutex caches_mutex;
+  static std::map<boost::filesystem::path, Cache> caches GUARDED_BY(caches_mutex);
+
+  /// Updates the directories of project that have changed, returns true if any directories were listed or removed
+  static bool update(const boost::filesystem::path &project_path, Cache &project) REQUIRES(caches_mutex);
+  static void list_directory(const boost::filesystem::path &project_path, const Cache &project, const std::string &relative_path, Directory &directory);
+};
@@ -1,9 +1,108 @@
 #include "selection_dialog.h"
+#include "utility.h"
 #include <algorithm>
 
+SelectionDialogBase::ListViewText::Model::Model(const ColumnRecord &column_record)
+    : Glib::ObjectBase(typeid(Model)), Glib::Object(), column_record(column_record), stamp(g_random_int()) {}
+
+void SelectionDialogBase::ListViewText::Model::append(std::string row, bool visible) {
+  rows.emplace_back(std::move(row));
+  if(visible) {
+    visible_rows.emplace_back(rows.size() - 1);
+    iterator iter;
+    set_iter(visible_rows.size() - 1, iter);
+    row_inserted(Path(1, visible_rows.size() - 1), iter);
+  }
+}
+
+bool SelectionDialogBase::ListViewText::Model::set_iter(size_t position, iterator &iter) const {
+  if(position >= visible_rows.size())
+    return false;
+  iter.set_stamp(stamp);
+  iter.gobj()->user_data = GSIZE_TO_POINTER(position);
+  return true;
+}
+
+Gtk::TreeModelFlags SelectionDialogBase::ListViewText::Model::get_flags_vfunc() const {
+  return Gtk::TREE_MODEL_LIST_ONLY;
+}
+
+int SelectionDialogBase::ListViewText::Model::get_n_columns_vfunc() const {
+  return column_record.size();
+}
+
+GType SelectionDialogBase::ListViewText::Model::get_column_type_vfunc(int index) const {
+  return column_record.types()[index];
+}
+
+void SelectionDialogBase::ListViewText::Model::get_value_vfunc(const iterator &iter, int column, Glib::ValueBase &value) const {
+  auto position = GPOINTER_TO_SIZE(iter.gobj()->user_data);
+  if(iter.get_stamp() != stamp || position >= visible_rows.size())
+    return;
+  auto index = visible_rows[position];
+  if(column == column_record.text.index()) {
+    Glib::Value<std::string> text;
+    text.init(Glib::Value<std::string>::value_type());
+    text.set(rows[index]);
+    value.init(Glib::Value<std::string>::value_type());
+    value = text;
+  }
+  else if(column == column_record.index.index()) {
+    Glib::Value<unsigned int> index_value;
+    index_value.init(Glib::Value<unsigned int>::value_type());
+    index_value.set(index);
+    value.init(Glib::Value<unsigned int>::value_type());
+    value = index_value;
+  }
+}
+
+bool SelectionDialogBase::ListViewText::Model::iter_next_vfunc(const iterator &iter, iterator &iter_next) const {
+  if(iter.get_stamp() != stamp)
+    return false;
+  return set_iter(GPOINTER_TO_SIZE(iter.gobj()->user_data) + 1, iter_next);
+}
+
+bool SelectionDialogBase::ListViewText::Model::iter_children_vfunc(const iterator &parent, iterator &iter) const {
+  return false;
+}
+
+bool SelectionDialogBase::ListViewText::Model::iter_has_child_vfunc(const iterator &iter) const {
+  return false;
+}
+
+int SelectionDialogBase::ListViewText::Model::iter_n_children_vfunc(const iterator &iter) const {
+  return 0;
+}
+
+int SelectionDialogBase::ListViewText::Model::iter_n_root_children_vfunc() const {
+  return visible_rows.size();
+}
+
+bool SelectionDialogBase::ListViewText::Model::iter_nth_child_vfunc(const iterator &parent, int n, iterator &iter) const {
+  return false;
+}
+
+bool SelectionDialogBase::ListViewText::Model::iter_nth_root_child_vfunc(int n, iterator &iter) const {
+  return n >= 0 && set_iter(n, iter);
+}
+
+bool SelectionDialogBase::ListViewText::Model::iter_parent_vfunc(const iterator &child, iterator &iter) const {
+  return false;
+}
+
+Gtk::TreeModel::Path SelectionDialogBase::ListViewText::Model::get_path_vfunc(const iterator &iter) const {
+  return Path(1, GPOINTER_TO_SIZE(iter.gobj()->user_data));
+}
+
+bool SelectionDialogBase::ListViewText::Model::get_iter_vfunc(const Path &path, iterator &iter) const {
+  if(path.size() != 1 || path[0] < 0)
+    return false;
+  return set_iter(path[0], iter);
+}
+
 SelectionDialogBase::ListViewText::ListViewText(bool use_markup) : Gtk::TreeView(), use_markup(use_markup) {
-  list_store = Gtk::ListStore::create(column_record);
-  set_model(list_store);
+  model = Model::create(column_record);
+  set_model(model);
   append_column("", cell_renderer);
   if(use_markup)
     get_column(0)->add_attribute(cell_renderer.property_markup(), column_record.text);
@@ -19,21 +118,38 @@ SelectionDialogBase::ListViewText::ListViewText(bool use_markup) : Gtk::TreeView
   set_rules_hint(true);
 }
 
-void SelectionDialogBase::ListViewText::append(const std::string &value) {
-  auto new_row = list_store->append();
-  new_row->set_value(column_record.text, value);
-  new_row->set_value(column_record.index, size++);
+void SelectionDialogBase::ListViewText::append(const std::string &value, bool visible) {
+  model->append(value, visible);
+}
+
+void SelectionDialogBase::ListViewText::set_visible_rows(std::vector<unsigned int> visible_rows) {
+  if(!model)
+    return;
+  // Replacing the model is cheaper than emitting a row-deleted and row-inserted signal per row
+  unset_model();
+  model->visible_rows = std::move(visible_rows);
+  set_model(model);
+}
+
+void SelectionDialogBase::ListViewText::set_all_rows_visible() {
+  if(!model)
+    return;
+  std::vector<unsigned int> visible_rows(model->rows.size());
+  for(size_t c = 0; c < visible_rows.size(); ++c)
+    visible_rows[c] = c;
+  set_visible_rows(std::move(visible_rows));
 }
 
 void SelectionDialogBase::ListViewText::erase_rows() {
-  list_store->clear();
-  size = 0;
+  unset_model();
+  model->rows.clear();
+  model->visible_rows.clear();
+  set_model(model);
 }
 
 void SelectionDialogBase::ListViewText::clear() {
   unset_model();
-  list_store.reset();
-  size = 0;
+  model.reset();
 }
 
 SelectionDialogBase::SelectionDialogBase(Gtk::TextView *text_view, const Glib::RefPtr<Gtk::TextBuffer::Mark> &start_mark, bool show_search_entry, bool use_markup)
@@ -152,6 +268,7 @@ void SelectionDialogBase::add_row(const std::string &row) {
 
 void SelectionDialogBase::erase_rows() {
   list_view_text.erase_rows();
+  last_index = static_cast<unsigned int>(-1);
 }
 
 void SelectionDialogBase::show() {
@@ -175,6 +292,14 @@ void SelectionDialogBase::show() {
     on_show();
 }
 
+void SelectionDialogBase::set_cursor_at_first_row() {
+  auto children = list_view_text.get_model()->children();
+  if(children.size() > 0) {
+    list_view_text.set_cursor(list_view_text.get_model()->get_path(children.begin()));
+    cursor_changed();
+  }
+}
+
 void SelectionDialogBase::set_cursor_at_last_row() {
   auto children = list_view_text.get_model()->children();
   if(children.size() > 0) {
@@ -197,42 +322,12 @@ std::unique_ptr<SelectionDialog> SelectionDialog::instance;
 
 SelectionDialog::SelectionDialog(Gtk::TextView *text_view, const Glib::RefPtr<Gtk::TextBuffer::Mark> &start_mark, bool show_search_entry, bool use_markup)
     : SelectionDialogBase(text_view, start_mark, show_search_entry, use_markup) {
-  auto search_key = std::make_shared<std::string>();
-  auto filter_model = Gtk::TreeModelFilter::create(list_view_text.get_model());
-
-  filter_model->set_visible_func([this, search_key](const Gtk::TreeModel::const_iterator &iter) {
-    std::string row_lc;
-    iter->get_value(0, row_lc);
-    auto search_key_lc = *search_key;
-    std::transform(row_lc.begin(), row_lc.end(), row_lc.begin(), ::tolower);
-    std::transform(search_key_lc.begin(), search_key_lc.end(), search_key_lc.begin(), ::tolower);
-    if(list_view_text.use_markup) {
-      size_t pos = 0;
-      while((pos = row_lc.find('<', pos)) != std::string::npos) {
-        auto pos2 = row_lc.find('>', pos + 1);
-        row_lc.erase(pos, pos2 - pos + 1);
-      }
-      search_key_lc = Glib::Markup::escape_text(search_key_lc);
-    }
-    if(row_lc.find(search_key_lc) != std::string::npos)
-      return true;
-    return false;
-  });
-
-  list_view_text.set_model(filter_model);
-
   list_view_text.set_search_equal_func([](const Glib::RefPtr<Gtk::TreeModel> &model, int column, const Glib::ustring &key, const Gtk::TreeModel::iterator &iter) {
     return false;
   });
 
-  search_entry.signal_changed().connect([this, search_key, filter_model]() {
-    *search_key = search_entry.get_text();
-    filter_model->refilter();
-    list_view_text.set_search_entry(search_entry); //TODO:Report the need of this to GTK's git (bug)
-    if(search_key->empty()) {
-      if(list_view_text.get_model()->children().size() > 0)
-        list_view_text.set_cursor(list_view_text.get_model()->get_path(list_view_text.get_model()->children().begin()));
-    }
+  search_entry.signal_changed().connect([this]() {
+    search(search_entry.get_text());
   });
 
   auto activate = [this]() {
@@ -254,6 +349,121 @@ SelectionDialog::SelectionDialog(Gtk::TextView *text_view, const Glib::RefPtr<Gt
   });
 }
 
+SelectionDialog::~SelectionDialog() {
+  ++search_id;
+  if(search_thread.joinable())
+    search_thread.join();
+}
+
+void SelectionDialog::add_row(const std::string &row) {
+  auto key = to_lower_case(row);
+  if(list_view_text.use_markup) {
+    size_t pos = 0;
+    while((pos = key.find('<', pos)) != std::string::npos) {
+      auto pos2 = key.find('>', pos + 1);
+      key.erase(pos, pos2 - pos + 1);
+    }
+  }
+  bool visible = search_key_lc.empty() || fuzzy_match_score(search_key_lc, key) > 0;
+  if(visible && !search_key_lc.empty())
+    matches.emplace_back(list_view_text.size());
+  {
+    LockGuard lock(keys_mutex);
+    keys.emplace_back(std::move(key));
+  }
+  list_view_text.append(row, visible);
+}
+
+void SelectionDialog::erase_rows() {
+  ++search_id;
+  if(search_thread.joinable())
+    search_thread.join();
+  {
+    LockGuard lock(keys_mutex);
+    keys.clear();
+  }
+  matches.clear();
+  SelectionDialogBase::erase_rows();
+}
+
+void SelectionDialog::search(const std::string &text) {
+  auto key_lc = to_lower_case(text);
+  if(list_view_text.use_markup)
+    key_lc = Glib::Markup::escape_text(key_lc);
+
+  auto id = ++search_id;
+  if(search_thread.joinable())
+    search_thread.join();
+
+  if(key_lc.empty()) {
+    search_key_lc.clear();
+    matches.clear();
+    list_view_text.set_all_rows_visible();
+    list_view_text.set_search_entry(search_entry); //TODO:Report the need of this to GTK's git (bug)
+    set_cursor_at_first_row();
+    return;
+  }
+
+  size_t rows_size = list_view_text.size();
+  // When the search key is extended, only the previous matches need to be scored
+  std::vector<unsigned int> candidates;
+  if(!search_key_lc.empty() && key_lc.compare(0, search_key_lc.size(), search_key_lc) == 0)
+    candidates = matches;
+  else {
+    candidates.resize(rows_size);
+    for(size_t c = 0; c < rows_size; ++c)
+      candidates[c] = c;
+  }
+
+  search_thread = std::thread([this, id, key_lc = std::move(key_lc), candidates = std::move(candidates), rows_size]() mutable {
+    // keys_mutex is only held for a chunk at a time so that rows can be added while searching
+    std::vector<std::pair<int, unsigned int>> results;
+    for(size_t chunk_start = 0; chunk_start < candidates.size(); chunk_start += 1024) {
+      if(search_id != id)
+        return;
+      auto chunk_end = std::min(chunk_start + 1024, candidates.size());
+      LockGuard lock(keys_mutex);
+      for(auto c = chunk_start; c < chunk_end; ++c) {
+        auto score = fuzzy_match_score(key_lc, keys[candidates[c]]);
+        if(score > 0)
+          results.emplace_back(-score, candidates[c]);
+      }
+    }
+    std::sort(results.begin(), results.end());
+
+    dispatcher.post([this, id, key_lc = std::move(key_lc), results = std::move(results), rows_size]() mutable {
+      if(search_id != id || !is_visible())
+        return;
+
+      // Score rows added after the search was started
+      std::vector<std::pair<int, unsigned int>> added_results;
+      {
+        LockGuard lock(keys_mutex);
+        for(auto index = rows_size; index < keys.size(); ++index) {
+          auto score = fuzzy_match_score(key_lc, keys[index]);
+          if(score > 0)
+            added_results.emplace_back(-score, index);
+        }
+      }
+      if(!added_results.empty()) {
+        std::sort(added_results.begin(), added_results.end());
+        auto size = results.size();
+        results.insert(results.end(), added_results.begin(), added_results.end());
+        std::inplace_merge(results.begin(), results.begin() + size, results.end());
+      }
+
+      search_key_lc = std::move(key_lc);
+      matches.clear();
+      matches.reserve(results.size());
+      for(auto &result : results)
+        matches.emplace_back(result.second);
+      list_view_text.set_visible_rows(matches);
+      list_view_text.set_search_entry(search_entry); //TODO:Report the need of this to GTK's git (bug)
+      set_cursor_at_first_row();
+    });
+  });
+}
+
 bool SelectionDialog::on_key_press(GdkEventKey *key) {
   if((key->keyval == GDK_KEY_Down || key->keyval == GDK_KEY_KP_Down) && list_view_text.get_model()->children().size() > 0) {
     auto it = list_view_text.get_selection()->get_selected();
@@ -327,35 +537,10 @@ std::unique_ptr<CompletionDialog> CompletionDialog::instance;
 
 CompletionDialog::CompletionDialog(Gtk::TextView *text_view, const Glib::RefPtr<Gtk::TextBuffer::Mark> &start_mark) : SelectionDialogBase(text_view, start_mark, false, false) {
   show_offset = text_view->get_buffer()->get_insert()->get_iter().get_offset();
+  started_without_prefix = show_offset == start_mark->get_iter().get_offset();
 
-  auto search_key = std::make_shared<std::string>();
-  auto filter_model = Gtk::TreeModelFilter::create(list_view_text.get_model());
-  if(show_offset == start_mark->get_iter().get_offset()) {
-    filter_model->set_visible_func([search_key](const Gtk::TreeModel::const_iterator &iter) {
-      std::string row_lc;
-      iter->get_value(0, row_lc);
-      auto search_key_lc = *search_key;
-      std::transform(row_lc.begin(), row_lc.end(), row_lc.begin(), ::tolower);
-      std::transform(search_key_lc.begin(), search_key_lc.end(), search_key_lc.begin(), ::tolower);
-      if(row_lc.find(search_key_lc) != std::string::npos)
-        return true;
-      return false;
-    });
-  }
-  else {
-    filter_model->set_visible_func([search_key](const Gtk::TreeModel::const_iterator &iter) {
-      std::string row;
-      iter->get_value(0, row);
-      if(row.find(*search_key) == 0)
-        return true;
-      return false;
-    });
-  }
-  list_view_text.set_model(filter_model);
-  search_entry.signal_changed().connect([this, search_key, filter_model]() {
-    *search_key = search_entry.get_text();
-    filter_model->refilter();
-    list_view_text.set_search_entry(search_entry); //TODO:Report the need of this to GTK's git (bug)
+  search_entry.signal_changed().connect([this]() {
+    search(search_entry.get_text());
   });
 
   list_view_text.signal_row_activated().connect([this](const Gtk::TreeModel::Path &path, Gtk::TreeViewColumn *) {
@@ -369,6 +554,37 @@ CompletionDialog::CompletionDialog(Gtk::TextView *text_view, const Glib::RefPtr<
   }
 }
 
+bool CompletionDialog::is_match(const std::string &row) {
+  if(fuzzy_match) {
+    if(search_key_lc.empty())
+      return true;
+    // Only match the typed part of the row, that is before function parameters or return type
+    auto end = std::min(row.find("  →  "), row.find('('));
+    if(end == 0)
+      end = std::string::npos;
+    return fuzzy_match_score(search_key_lc, row.substr(0, end)) > 0;
+  }
+  if(started_without_prefix)
+    return to_lower_case(row).find(search_key_lc) != std::string::npos;
+  return row.compare(0, search_key.size(), search_key) == 0;
+}
+
+void CompletionDialog::search(const std::string &text) {
+  search_key = text;
+  search_key_lc = to_lower_case(text);
+  std::vector<unsigned int> visible_rows;
+  for(size_t c = 0; c < list_view_text.size(); ++c) {
+    if(is_match(list_view_text.get_row(c)))
+      visible_rows.emplace_back(c);
+  }
+  list_view_text.set_visible_rows(std::move(visible_rows));
+  list_view_text.set_search_entry(search_entry); //TODO:Report the need of this to GTK's git (bug)
+}
+
+void CompletionDialog::add_row(const std::string &row) {
+  list_view_text.append(row, is_match(row));
+}
+
 void CompletionDialog::select(bool hide_window) {
   row_in_entry = true;
 
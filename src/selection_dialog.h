@@ -1,7 +1,12 @@
 #pragma once
+#include "dispatcher.h"
 #include "gtkmm.h"
+#include "mutex.h"
+#include <atomic>
 #include <functional>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 class SelectionDialogBase {
   class ListViewText : public Gtk::TreeView {
@@ -15,18 +20,63 @@ class SelectionDialogBase {
       Gtk::TreeModelColumn<unsigned int> index;
     };
 
+    /// List model that stores the rows in a vector, and only shows the rows given by a vector of row indices.
+    /// Compared to Gtk::ListStore and Gtk::TreeModelFilter, no row values are stored in GTK,
+    /// and the row text is only read when a row is rendered.
+    class Model : public Glib::Object, public Gtk::TreeModel {
+      Model(const ColumnRecord &column_record);
+
+    public:
+      static Glib::RefPtr<Model> create(const ColumnRecord &column_record) { return Glib::RefPtr<Model>(new Model(column_record)); }
+
+      std::vector<std::string> rows;
+      /// Indices of the rows that are shown
+      std::vector<unsigned int> visible_rows;
+
+      /// Adds row, and shows it at the end of the list if visible is true
+      void append(std::string row, bool visible);
+
+    protected:
+      Gtk::TreeModelFlags get_flags_vfunc() const override;
+      int get_n_columns_vfunc() const override;
+      GType get_column_type_vfunc(int index) const override;
+      void get_value_vfunc(const iterator &iter, int column, Glib::ValueBase &value) const override;
+      bool iter_next_vfunc(const iterator &iter, iterator &iter_next) const override;
+      bool iter_children_vfunc(const iterator &parent, iterator &iter) const override;
+      bool iter_has_child_vfunc(const iterator &iter) const override;
+      int iter_n_children_vfunc(const iterator &iter) const override;
+      int iter_n_root_children_vfunc() const override;
+      bool iter_nth_child_vfunc(const iterator &parent, int n, iterator &iter) const override;
+      bool iter_nth_root_child_vfunc(int n, iterator &iter) const override;
+      bool iter_parent_vfunc(const iterator &child, iterator &iter) const override;
+      Path get_path_vfunc(const iterator &iter) const override;
+      bool get_iter_vfunc(const Path &path, iterator &iter) const override;
+
+    private:
+      const ColumnRecord &column_record;
+      int stamp;
+
+      /// Sets iter to the visible row at position, returns false if position is out of range
+      bool set_iter(size_t position, iterator &iter) const;
+    };
+
   public:
     bool use_markup;
     ColumnRecord column_record;
     ListViewText(bool use_markup);
-    void append(const std::string &value);
+    void append(const std::string &value, bool visible = true);
+    /// Shows the given rows in the given order
+    void set_visible_rows(std::vector<unsigned int> visible_rows);
+    /// Shows all rows in the order they were added
+    void set_all_rows_visible();
+    size_t size() const { return model ? model->rows.size() : 0; }
+    const std::string &get_row(size_t index) const { return model->rows[index]; }
     void erase_rows();
     void clear();
 
   private:
-    Glib::RefPtr<Gtk::ListStore> list_store;
+    Glib::RefPtr<Model> model;
     Gtk::CellRendererText cell_renderer;
-    unsigned int size = 0;
   };
 
   class SearchEntry : public Gtk::Entry {
@@ -38,8 +88,9 @@ class SelectionDialogBase {
 public:
   SelectionDialogBase(Gtk::TextView *text_view, const Glib::RefPtr<Gtk::TextBuffer::Mark> &start_mark, bool show_search_entry, bool use_markup);
   virtual ~SelectionDialogBase();
-  void add_row(const std::string &row);
-  void erase_rows();
+  virtual void add_row(const std::string &row);
+  virtual void erase_rows();
+  void set_cursor_at_first_row();
   void set_cursor_at_last_row();
   void show();
   void hide();
@@ -72,7 +123,28 @@ class SelectionDialog : public SelectionDialogBase {
   SelectionDialog(Gtk::TextView *text_view, const Glib::RefPtr<Gtk::TextBuffer::Mark> &start_mark, bool show_search_entry, bool use_markup);
   static std::unique_ptr<SelectionDialog> instance;
 
+  /// Lowercase rows without markup, used when searching
+  Mutex keys_mutex;
+  std::vector<std::string> keys GUARDED_BY(keys_mutex);
+
+  /// Lowercase search key, escaped if markup is used
+  std::string search_key_lc;
+  /// Indices of rows matching search_key_lc, used to narrow the search when the search key is extended
+  std::vector<unsigned int> matches;
+
+  Dispatcher dispatcher;
+  std::thread search_thread;
+  std::atomic<size_t> search_id = {0};
+
+  /// Scores the rows in search_thread, and shows the matching rows sorted by score when done
+  void search(const std::string &text);
+
 public:
+  ~SelectionDialog() override;
+
+  void add_row(const std::string &row) override;
+  void erase_rows() override;
+
   bool on_key_press(GdkEventKey *key);
 
   static void create(Gtk::TextView *text_view, const Glib::RefPtr<Gtk::TextBuffer::Mark> &start_mark, bool show_search_entry = true, bool use_markup = false) {
@@ -88,7 +160,20 @@ class CompletionDialog : public SelectionDialogBase {
   CompletionDialog(Gtk::TextView *text_view, const Glib::RefPtr<Gtk::TextBuffer::Mark> &start_mark);
   static std::unique_ptr<CompletionDialog> instance;
 
+  std::string search_key;
+  std::string search_key_lc;
+
+  /// Returns true if row matches the search key. See fuzzy_match.
+  bool is_match(const std::string &row);
+  void search(const std::string &text);
+
 public:
+  /// If true, the typed part of the rows, before function parameters and return types, is fuzzy matched.
+  /// If false, the rows must start with the search key, or contain it case insensitively if the completion started without a prefix.
+  bool fuzzy_match = false;
+
+  void add_row(const std::string &row) override;
+
   bool on_key_release(GdkEventKey *key);
   bool on_key_press(GdkEventKey *key);
 
@@ -101,5 +186,6 @@ private:
   void select(bool hide_window = true);
 
   int show_offset;
+  bool started_without_prefix;
   bool row_in_entry = false;
 };
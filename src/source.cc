@@ -85,7 +85,7 @@ Source::FixIt::FixIt(std::string source_, std::pair<Offset, Offset> offsets_) :
   }
 }
 
-std::string Source::FixIt::string(const Glib::RefPtr<Gtk::TextBuffer> &buffer) {
+std::string Source::FixIt::string(const Glib::RefPtr<Gtk::TextBuffer> &buffer) const {
   auto iter = buffer->get_iter_at_line_index(offsets.first.line, offsets.first.index);
   unsigned first_line_offset = iter.get_line_offset() + 1;
   iter = buffer->get_iter_at_line_index(offsets.second.line, offsets.second.index);
@@ -152,6 +152,17 @@ Source::View::View(const boost::filesystem::path &file_path, const Glib::RefPtr<
   rgba.set_blue(0.75);
   mark_attr_debug_breakpoint_and_stop->set_background(rgba);
   set_mark_attributes("debug_breakpoint_and_stop", mark_attr_debug_breakpoint_and_stop, 102);
+  auto mark_attr_build_error = Gsv::MarkAttributes::create();
+  rgba.set_red(1.0);
+  rgba.set_green(0.0);
+  rgba.set_blue(0.0);
+  rgba.set_alpha(0.15);
+  mark_attr_build_error->set_background(rgba);
+  set_mark_attributes("build_error", mark_attr_build_error, 90);
+  auto mark_attr_build_warning = Gsv::MarkAttributes::create();
+  rgba.set_green(1.0);
+  mark_attr_build_warning->set_background(rgba);
+  set_mark_attributes("build_warning", mark_attr_build_warning, 89);
 
   link_tag = get_buffer()->create_tag("link");
 
@@ -1676,12 +1687,24 @@ void Source::View::insert_with_links_tagged(const Glib::RefPtr<Gtk::TextBuffer>
   buffer->insert(buffer->get_insert()->get_iter(), &text[start_pos], &text[text.size()]);
 }
 
-void Source::View::add_diagnostic_tooltip(const Gtk::TextIter &start, const Gtk::TextIter &end, bool error, std::function<void(const Glib::RefPtr<Gtk::TextBuffer> &)> &&set_buffer) {
+void Source::View::add_build_diagnostic_mark(int line, bool error) {
+  if(line < 0 || line >= get_buffer()->get_line_count())
+    return;
+  auto iter = get_buffer()->get_iter_at_line(line);
+  gtk_source_buffer_create_source_mark(get_source_buffer()->gobj(), nullptr, error ? "build_error" : "build_warning", iter.gobj()); // Gsv::Buffer::create_source_mark is bugged
+}
+
+void Source::View::clear_build_diagnostic_marks() {
+  get_source_buffer()->remove_source_marks(get_buffer()->begin(), get_buffer()->end(), "build_error");
+  get_source_buffer()->remove_source_marks(get_buffer()->begin(), get_buffer()->end(), "build_warning");
+}
+
+std::list<Tooltip>::iterator Source::View::add_diagnostic_tooltip(const Gtk::TextIter &start, const Gtk::TextIter &end, bool error, std::function<void(const Glib::RefPtr<Gtk::TextBuffer> &)> &&set_buffer) {
   diagnostic_offsets.emplace(start.get_offset());
 
   std::string severity_tag_name = error ? "def:error" : "def:warning";
 
-  diagnostic_tooltips.emplace_back(this, get_buffer()->create_mark(start), get_buffer()->create_mark(end), [error, severity_tag_name, set_buffer = std::move(set_buffer)](const Glib::RefPtr<Gtk::TextBuffer> &buffer) {
+  auto tooltip = diagnostic_tooltips.emplace_back(this, get_buffer()->create_mark(start), get_buffer()->create_mark(end), [error, severity_tag_name, set_buffer = std::move(set_buffer)](const Glib::RefPtr<Gtk::TextBuffer> &buffer) {
     buffer->insert_with_tag(buffer->get_insert()->get_iter(), error ? "Error" : "Warning", severity_tag_name);
     buffer->insert(buffer->get_insert()->get_iter(), ":\n");
     set_buffer(buffer);
@@ -1695,6 +1718,8 @@ void Source::View::add_diagnostic_tooltip(const Gtk::TextIter &start, const Gtk:
     if(next_iter.forward_char())
       get_buffer()->remove_tag_by_name(severity_tag_name + "_underline", iter, next_iter);
   }
+
+  return tooltip;
 }
 
 void Source::View::clear_diagnostic_tooltips() {
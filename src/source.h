@@ -45,7 +45,7 @@ namespace Source {
 
     FixIt(std::string source_, std::pair<Offset, Offset> offsets_);
 
-    std::string string(const Glib::RefPtr<Gtk::TextBuffer> &buffer);
+    std::string string(const Glib::RefPtr<Gtk::TextBuffer> &buffer) const;
 
     Type type;
     std::string source;
@@ -89,6 +89,10 @@ namespace Source {
 
     void show_or_hide(); /// Show or hide text selection
 
+    /// Marks a line, starting at 0, with an error or warning from the last build
+    void add_build_diagnostic_mark(int line, bool error);
+    void clear_build_diagnostic_marks();
+
     bool soft_reparse_needed = false;
     bool full_reparse_needed = false;
     virtual void soft_reparse(bool delayed = false) { soft_reparse_needed = false; }
@@ -115,7 +119,7 @@ namespace Source {
     Glib::RefPtr<Gtk::TextTag> hide_tag;
 
     virtual void show_diagnostic_tooltips(const Gdk::Rectangle &rectangle) { diagnostic_tooltips.show(rectangle); }
-    void add_diagnostic_tooltip(const Gtk::TextIter &start, const Gtk::TextIter &end, bool error, std::function<void(const Glib::RefPtr<Gtk::TextBuffer> &)> &&set_buffer);
+    std::list<Tooltip>::iterator add_diagnostic_tooltip(const Gtk::TextIter &start, const Gtk::TextIter &end, bool error, std::function<void(const Glib::RefPtr<Gtk::TextBuffer> &)> &&set_buffer);
     void clear_diagnostic_tooltips();
     std::set<int> diagnostic_offsets;
     void place_cursor_at_next_diagnostic();
@@ -13,10 +13,15 @@
 #include "info.h"
 #include "selection_dialog.h"
 #include "usages_clang.h"
+#include "utility.h"
+#include <algorithm>
 
 const std::regex include_regex(R"(^[ \t]*#[ \t]*include[ \t]*[<"]([^<>"]+)[>"].*$)");
 
-Source::ClangViewParse::ClangViewParse(const boost::filesystem::path &file_path, const Glib::RefPtr<Gsv::Language> &language)
+/// Maximum number of completion rows passed to the completion dialog
+const size_t max_completion_rows = 500;
+
+Source::ClangViewParse::ClangViewParse(const boost::filesystem::path &file_path, const Glib::RefPtr<Gsv::Language> &language, bool delay_parse)
     : BaseView(file_path, language), Source::View(file_path, language) {
   Usages::Clang::erase_cache(file_path);
 
@@ -36,7 +41,16 @@ Source::ClangViewParse::ClangViewParse(const boost::filesystem::path &file_path,
     Info::get().print("Added \"#pragma once\" to empty C/C++ header file");
   }
 
-  parse_initialize();
+  if(delay_parse) {
+    parsed = false;
+    parse_state = ParseState::STOP;
+    delayed_parse_initialize_connection = signal_map().connect([this] {
+      delayed_parse_initialize_connection.disconnect();
+      parse_initialize();
+    });
+  }
+  else
+    parse_initialize();
 
   get_buffer()->signal_changed().connect([this]() {
     soft_reparse(true);
@@ -123,11 +137,8 @@ void Source::ClangViewParse::parse_initialize() {
   build->update_default();
   auto arguments = CompileCommands::get_arguments(build->get_default_path(), file_path);
   clang_tu = std::make_unique<clangmm::TranslationUnit>(std::make_shared<clangmm::Index>(0, Config::get().log.libclang), file_path.string(), arguments, &buffer_raw);
-  clang_tokens = clang_tu->get_tokens();
-  clang_tokens_offsets.clear();
-  clang_tokens_offsets.reserve(clang_tokens->size());
-  for(auto &token : *clang_tokens)
-    clang_tokens_offsets.emplace_back(token.get_source_range().get_offsets());
+  update_tokens();
+  ++parse_count;
   {
     LockGuard lock(parse_mutex);
     update_syntax();
@@ -147,8 +158,10 @@ void Source::ClangViewParse::parse_initialize() {
         dispatcher.post([this] {
           auto expected = ParseProcessState::PREPROCESSING;
           if(parse_mutex.try_lock()) {
-            if(parse_process_state.compare_exchange_strong(expected, ParseProcessState::PROCESSING))
+            if(parse_process_state.compare_exchange_strong(expected, ParseProcessState::PROCESSING)) {
               parse_thread_buffer = get_buffer()->get_text();
+              parse_thread_file_path = file_path.string();
+            }
             parse_mutex.unlock();
           }
           else
@@ -163,12 +176,11 @@ void Source::ClangViewParse::parse_initialize() {
         if(status == 0) {
           auto expected = ParseProcessState::PROCESSING;
           if(parse_process_state.compare_exchange_strong(expected, ParseProcessState::POSTPROCESSING)) {
-            clang_tokens = clang_tu->get_tokens();
-            clang_tokens_offsets.clear();
-            clang_tokens_offsets.reserve(clang_tokens->size());
-            for(auto &token : *clang_tokens)
-              clang_tokens_offsets.emplace_back(token.get_source_range().get_offsets());
+            update_tokens();
             clang_diagnostics = clang_tu->get_diagnostics();
+            process_diagnostics();
+            update_methods();
+            ++parse_count;
             parse_mutex.unlock();
             dispatcher.post([this] {
               if(parse_mutex.try_lock()) {
@@ -176,6 +188,7 @@ void Source::ClangViewParse::parse_initialize() {
                 if(parse_process_state.compare_exchange_strong(expected, ParseProcessState::IDLE)) {
                   update_syntax();
                   update_diagnostics();
+                  methods = std::move(parse_thread_methods);
                   parsed = true;
                   status_state = "";
                   if(update_status_state)
@@ -206,6 +219,25 @@ void Source::ClangViewParse::parse_initialize() {
   });
 }
 
+void Source::ClangViewParse::update_tokens() {
+  clang_tokens = clang_tu->get_tokens();
+  clang_tokens_offsets.clear();
+  clang_tokens_offsets.reserve(clang_tokens->size());
+  clang_identifier_tokens.clear();
+  for(size_t c = 0; c < clang_tokens->size(); ++c) {
+    auto &token = (*clang_tokens)[c];
+    clang_tokens_offsets.emplace_back(token.get_source_range().get_offsets());
+    if(token.is_identifier())
+      clang_identifier_tokens[token.get_spelling()].emplace_back(c);
+  }
+}
+
+std::pair<size_t, size_t> Source::ClangViewParse::get_token_indices_at_line(unsigned line) {
+  // clang_tokens_offsets is sorted since the tokens are in source order
+  auto range = std::equal_range(clang_tokens_offsets.begin(), clang_tokens_offsets.end(), line + 1, LineCompare());
+  return {range.first - clang_tokens_offsets.begin(), range.second - clang_tokens_offsets.begin()};
+}
+
 void Source::ClangViewParse::soft_reparse(bool delayed) {
   soft_reparse_needed = false;
   parsed = false;
@@ -279,80 +311,209 @@ void Source::ClangViewParse::update_syntax() {
   }
 }
 
-void Source::ClangViewParse::update_diagnostics() {
-  clear_diagnostic_tooltips();
-  fix_its.clear();
+void Source::ClangViewParse::update_methods() {
+  parse_thread_methods.clear();
+  clangmm::Offset last_offset{static_cast<unsigned>(-1), static_cast<unsigned>(-1)};
+  for(auto &token : *clang_tokens) {
+    if(token.is_identifier()) {
+      auto cursor = token.get_cursor();
+      auto kind = cursor.get_kind();
+      if(kind == clangmm::Cursor::Kind::FunctionDecl || kind == clangmm::Cursor::Kind::CXXMethod ||
+         kind == clangmm::Cursor::Kind::Constructor || kind == clangmm::Cursor::Kind::Destructor ||
+         kind == clangmm::Cursor::Kind::FunctionTemplate || kind == clangmm::Cursor::Kind::ConversionFunction) {
+        auto offset = cursor.get_source_location().get_offset();
+        if(offset == last_offset)
+          continue;
+        last_offset = offset;
+
+        std::string method;
+        if(kind != clangmm::Cursor::Kind::Constructor && kind != clangmm::Cursor::Kind::Destructor) {
+          method += cursor.get_type().get_result().get_spelling();
+          auto pos = method.find(' ');
+          if(pos != std::string::npos)
+            method.erase(pos, 1);
+          method += " ";
+        }
+        method += cursor.get_display_name();
+
+        std::string prefix;
+        auto parent = cursor.get_semantic_parent();
+        while(parent && parent.get_kind() != clangmm::Cursor::Kind::TranslationUnit) {
+          prefix.insert(0, parent.get_display_name() + (prefix.empty() ? "" : "::"));
+          parent = parent.get_semantic_parent();
+        }
+
+        method = Glib::Markup::escape_text(method);
+        //Add bold method token
+        size_t token_end_pos = method.find('(');
+        if(token_end_pos == std::string::npos)
+          continue;
+        auto token_start_pos = token_end_pos;
+        while(token_start_pos != 0 && method[token_start_pos] != ' ')
+          --token_start_pos;
+        method.insert(token_end_pos, "</b>");
+        method.insert(token_start_pos, "<b>");
+
+        if(!prefix.empty())
+          prefix += ':';
+        prefix += std::to_string(offset.line) + ": ";
+        prefix = Glib::Markup::escape_text(prefix);
+
+        parse_thread_methods.emplace_back(Offset(offset.line - 1, offset.index - 1), prefix + method);
+      }
+    }
+  }
+}
+
+void Source::ClangViewParse::process_diagnostics() {
+  size_t size = 0;
+  for(size_t c = 0; c < clang_diagnostics.size(); ++c) {
+    if(clang_diagnostics[c].path == parse_thread_file_path) {
+      if(c != size)
+        clang_diagnostics[size] = std::move(clang_diagnostics[c]);
+      ++size;
+    }
+  }
+  clang_diagnostics.erase(clang_diagnostics.begin() + size, clang_diagnostics.end());
+
+  auto hash_combine = [](size_t &hash, size_t value) {
+    hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  };
   size_t num_warnings = 0;
   size_t num_errors = 0;
   size_t num_fix_its = 0;
+  clang_diagnostics_hashes.clear();
+  clang_diagnostics_hashes.reserve(clang_diagnostics.size());
   for(auto &diagnostic : clang_diagnostics) {
-    if(diagnostic.path == file_path.string()) {
-      int line = diagnostic.offsets.first.line - 1;
-      if(line < 0 || line >= get_buffer()->get_line_count())
-        line = get_buffer()->get_line_count() - 1;
-      auto start = get_iter_at_line_end(line);
-      int index = diagnostic.offsets.first.index - 1;
-      if(index >= 0 && index < start.get_line_index())
-        start = get_buffer()->get_iter_at_line_index(line, index);
-      if(start.ends_line()) {
-        while(!start.is_start() && start.ends_line())
-          start.backward_char();
-      }
-      diagnostic_offsets.emplace(start.get_offset());
-
-      line = diagnostic.offsets.second.line - 1;
-      if(line < 0 || line >= get_buffer()->get_line_count())
-        line = get_buffer()->get_line_count() - 1;
-      auto end = get_iter_at_line_end(line);
-      index = diagnostic.offsets.second.index - 1;
-      if(index >= 0 && index < end.get_line_index())
-        end = get_buffer()->get_iter_at_line_index(line, index);
-
-      bool error = false;
-      std::string severity_tag_name;
-      if(diagnostic.severity <= clangmm::Diagnostic::Severity::Warning) {
-        severity_tag_name = "def:warning";
-        num_warnings++;
-      }
-      else {
-        severity_tag_name = "def:error";
-        num_errors++;
-        error = true;
-      }
+    if(diagnostic.severity <= clangmm::Diagnostic::Severity::Warning)
+      num_warnings++;
+    else
+      num_errors++;
+    num_fix_its += diagnostic.fix_its.size();
+
+    auto hash = std::hash<std::string>()(diagnostic.spelling);
+    hash_combine(hash, static_cast<size_t>(diagnostic.severity));
+    for(auto &fix_it : diagnostic.fix_its) {
+      hash_combine(hash, std::hash<std::string>()(fix_it.source));
+      hash_combine(hash, fix_it.offsets.first.line);
+      hash_combine(hash, fix_it.offsets.first.index);
+      hash_combine(hash, fix_it.offsets.second.line);
+      hash_combine(hash, fix_it.offsets.second.index);
+    }
+    clang_diagnostics_hashes.emplace_back(hash);
+  }
+  clang_diagnostics_status = std::make_tuple(num_warnings, num_errors, num_fix_its);
+}
 
-      std::string fix_its_string;
-      unsigned fix_its_count = 0;
-      for(auto &fix_it : diagnostic.fix_its) {
-        auto clang_offsets = fix_it.offsets;
-        std::pair<Offset, Offset> offsets;
-        offsets.first.line = clang_offsets.first.line - 1;
-        offsets.first.index = clang_offsets.first.index - 1;
-        offsets.second.line = clang_offsets.second.line - 1;
-        offsets.second.index = clang_offsets.second.index - 1;
-
-        fix_its.emplace_back(fix_it.source, offsets);
-
-        if(fix_its_string.size() > 0)
-          fix_its_string += '\n';
-        fix_its_string += fix_its.back().string(get_buffer());
-        fix_its_count++;
-        num_fix_its++;
-      }
+void Source::ClangViewParse::update_diagnostics() {
+  auto buffer = get_buffer();
+  fix_its.clear();
+
+  // Previously shown diagnostics are kept if both their range and hash are unchanged
+  std::map<std::tuple<int, int, size_t>, size_t> previous_diagnostics;
+  for(size_t c = 0; c < diagnostic_tooltip_list.size(); ++c) {
+    auto &diagnostic_tooltip = diagnostic_tooltip_list[c];
+    previous_diagnostics.emplace(std::make_tuple(diagnostic_tooltip.tooltip->start_mark->get_iter().get_offset(), diagnostic_tooltip.tooltip->end_mark->get_iter().get_offset(), diagnostic_tooltip.hash), c);
+  }
+  std::vector<bool> keep(diagnostic_tooltip_list.size(), false);
+  std::vector<DiagnosticTooltip> new_diagnostic_tooltip_list;
+  std::vector<std::tuple<size_t, int, int, std::vector<FixIt>>> added_diagnostics; // Diagnostic index, start offset, end offset and fix-its
+
+  for(size_t c = 0; c < clang_diagnostics.size(); ++c) {
+    auto &diagnostic = clang_diagnostics[c];
+    int line = diagnostic.offsets.first.line - 1;
+    if(line < 0 || line >= buffer->get_line_count())
+      line = buffer->get_line_count() - 1;
+    auto start = get_iter_at_line_end(line);
+    int index = diagnostic.offsets.first.index - 1;
+    if(index >= 0 && index < start.get_line_index())
+      start = buffer->get_iter_at_line_index(line, index);
+    if(start.ends_line()) {
+      while(!start.is_start() && start.ends_line())
+        start.backward_char();
+    }
 
-      if(fix_its_count == 1)
-        fix_its_string.insert(0, "Fix-it:\n");
-      else if(fix_its_count > 1)
-        fix_its_string.insert(0, "Fix-its:\n");
+    line = diagnostic.offsets.second.line - 1;
+    if(line < 0 || line >= buffer->get_line_count())
+      line = buffer->get_line_count() - 1;
+    auto end = get_iter_at_line_end(line);
+    index = diagnostic.offsets.second.index - 1;
+    if(index >= 0 && index < end.get_line_index())
+      end = buffer->get_iter_at_line_index(line, index);
+
+    std::vector<FixIt> diagnostic_fix_its;
+    for(auto &fix_it : diagnostic.fix_its) {
+      auto clang_offsets = fix_it.offsets;
+      std::pair<Offset, Offset> offsets;
+      offsets.first.line = clang_offsets.first.line - 1;
+      offsets.first.index = clang_offsets.first.index - 1;
+      offsets.second.line = clang_offsets.second.line - 1;
+      offsets.second.index = clang_offsets.second.index - 1;
+
+      fix_its.emplace_back(fix_it.source, offsets);
+      diagnostic_fix_its.emplace_back(fix_its.back());
+    }
 
-      if(!fix_its_string.empty())
-        diagnostic.spelling += "\n\n" + fix_its_string;
+    auto it = previous_diagnostics.find(std::make_tuple(start.get_offset(), end.get_offset(), clang_diagnostics_hashes[c]));
+    if(it != previous_diagnostics.end() && !keep[it->second]) {
+      keep[it->second] = true;
+      new_diagnostic_tooltip_list.emplace_back(diagnostic_tooltip_list[it->second]);
+    }
+    else
+      added_diagnostics.emplace_back(c, start.get_offset(), end.get_offset(), std::move(diagnostic_fix_its));
+  }
 
-      add_diagnostic_tooltip(start, end, error, [spelling = std::move(diagnostic.spelling)](const Glib::RefPtr<Gtk::TextBuffer> &buffer) {
-        buffer->insert_at_cursor(spelling);
-      });
+  // Remove diagnostics that are no longer present
+  std::vector<std::pair<int, int>> removed_ranges;
+  for(size_t c = 0; c < diagnostic_tooltip_list.size(); ++c) {
+    if(!keep[c]) {
+      auto &diagnostic_tooltip = diagnostic_tooltip_list[c];
+      auto start = diagnostic_tooltip.tooltip->start_mark->get_iter();
+      auto end = diagnostic_tooltip.tooltip->end_mark->get_iter();
+      buffer->remove_tag_by_name(diagnostic_tooltip.error ? "def:error_underline" : "def:warning_underline", start, end);
+      removed_ranges.emplace_back(start.get_offset(), end.get_offset());
+      diagnostic_tooltips.erase(diagnostic_tooltip.tooltip);
     }
   }
-  status_diagnostics = std::make_tuple(num_warnings, num_errors, num_fix_its);
+  // Restore underlines of kept diagnostics that overlapped removed diagnostics
+  if(!removed_ranges.empty()) {
+    for(auto &diagnostic_tooltip : new_diagnostic_tooltip_list) {
+      auto start = diagnostic_tooltip.tooltip->start_mark->get_iter();
+      auto end = diagnostic_tooltip.tooltip->end_mark->get_iter();
+      for(auto &range : removed_ranges) {
+        if(start.get_offset() <= range.second && range.first <= end.get_offset()) {
+          buffer->apply_tag_by_name(diagnostic_tooltip.error ? "def:error_underline" : "def:warning_underline", start, end);
+          break;
+        }
+      }
+    }
+  }
+
+  for(auto &added_diagnostic : added_diagnostics) {
+    auto c = std::get<0>(added_diagnostic);
+    auto &diagnostic = clang_diagnostics[c];
+    bool error = diagnostic.severity > clangmm::Diagnostic::Severity::Warning;
+
+    // The tooltip text is created when the tooltip is shown
+    auto tooltip = add_diagnostic_tooltip(buffer->get_iter_at_offset(std::get<1>(added_diagnostic)), buffer->get_iter_at_offset(std::get<2>(added_diagnostic)), error,
+                                          [this, spelling = std::move(diagnostic.spelling), diagnostic_fix_its = std::move(std::get<3>(added_diagnostic))](const Glib::RefPtr<Gtk::TextBuffer> &buffer) {
+                                            buffer->insert_at_cursor(spelling);
+                                            if(!diagnostic_fix_its.empty()) {
+                                              std::string fix_its_string = diagnostic_fix_its.size() == 1 ? "\n\nFix-it:" : "\n\nFix-its:";
+                                              for(auto &fix_it : diagnostic_fix_its)
+                                                fix_its_string += '\n' + fix_it.string(get_buffer());
+                                              buffer->insert_at_cursor(fix_its_string);
+                                            }
+                                          });
+    new_diagnostic_tooltip_list.emplace_back(DiagnosticTooltip{clang_diagnostics_hashes[c], error, tooltip});
+  }
+  diagnostic_tooltip_list = std::move(new_diagnostic_tooltip_list);
+
+  diagnostic_offsets.clear();
+  for(auto &diagnostic_tooltip : diagnostic_tooltip_list)
+    diagnostic_offsets.emplace(diagnostic_tooltip.tooltip->start_mark->get_iter().get_offset());
+
+  status_diagnostics = clang_diagnostics_status;
   if(update_status_diagnostics)
     update_status_diagnostics(this);
 }
@@ -372,7 +533,8 @@ void Source::ClangViewParse::show_type_tooltips(const Gdk::Rectangle &rectangle)
     auto line = static_cast<unsigned>(iter.get_line());
     auto index = static_cast<unsigned>(iter.get_line_index());
     type_tooltips.clear();
-    for(size_t c = clang_tokens->size() - 1; c != static_cast<size_t>(-1); --c) {
+    auto token_indices = get_token_indices_at_line(line);
+    for(size_t c = token_indices.second - 1; c != token_indices.first - 1; --c) {
       auto &token = (*clang_tokens)[c];
       auto &token_offsets = clang_tokens_offsets[c];
       auto token_spelling = token.get_spelling();
@@ -553,7 +715,6 @@ Source::ClangViewAutocomplete::ClangViewAutocomplete(const boost::filesystem::pa
 
   autocomplete.reparse = [this] {
     selected_completion_string = nullptr;
-    code_complete_results = nullptr;
     soft_reparse(true);
   };
 
@@ -695,35 +856,53 @@ Source::ClangViewAutocomplete::ClangViewAutocomplete(const boost::filesystem::pa
   autocomplete.on_add_rows_error = [this] {
     Terminal::get().print("Error: autocomplete failed, reparsing " + this->file_path.string() + '\n', true);
     selected_completion_string = nullptr;
-    code_complete_results = nullptr;
+    completion_cache = nullptr;
     full_reparse();
   };
 
+  autocomplete.fuzzy_match = true;
+
   autocomplete.add_rows = [this](std::string &buffer, int line_number, int column) {
     if(this->language && (this->language->get_id() == "chdr" || this->language->get_id() == "cpphdr"))
       clangmm::remove_include_guard(buffer);
-    code_complete_results = std::make_unique<clangmm::CodeCompleteResults>(clang_tu->get_code_completions(buffer, line_number, column));
-    if(code_complete_results->cx_results == nullptr) {
-      auto expected = ParseState::PROCESSING;
-      parse_state.compare_exchange_strong(expected, ParseState::RESTARTING);
-      return;
-    }
 
-    if(autocomplete.state == Autocomplete::State::STARTING) {
-      std::string prefix;
-      {
-        LockGuard lock(autocomplete.prefix_mutex);
-        prefix = autocomplete.prefix;
+    // The context is the buffer without the spaces that replaced the word at the completion location
+    size_t pos = 0;
+    for(int line = 1; line < line_number && pos < buffer.size(); ++line) {
+      pos = buffer.find('\n', pos);
+      if(pos == std::string::npos)
+        pos = buffer.size();
+      else
+        ++pos;
+    }
+    pos = std::min(pos + column - 1, buffer.size());
+    auto end_pos = pos;
+    while(end_pos < buffer.size() && buffer[end_pos] == ' ')
+      ++end_pos;
+    auto context_hash = std::hash<std::string>()(buffer.substr(0, pos)) ^ (std::hash<std::string>()(buffer.substr(end_pos)) << 1);
+
+    if(!completion_cache || completion_cache->parse_count != parse_count || completion_cache->line_number != line_number || completion_cache->column != column ||
+       completion_cache->context_hash != context_hash || completion_cache->show_parameters != show_parameters) {
+      completion_cache = nullptr;
+      auto results = std::make_unique<clangmm::CodeCompleteResults>(clang_tu->get_code_completions(buffer, line_number, column));
+      if(results->cx_results == nullptr) {
+        auto expected = ParseState::PROCESSING;
+        parse_state.compare_exchange_strong(expected, ParseState::RESTARTING);
+        return;
       }
 
-      completion_strings.clear();
-      snippet_inserts.clear();
-      snippet_comments.clear();
-      for(unsigned i = 0; i < code_complete_results->size(); ++i) {
-        auto result = code_complete_results->get(i);
+      auto cache = std::make_unique<CompletionCache>();
+      cache->parse_count = parse_count;
+      cache->line_number = line_number;
+      cache->column = column;
+      cache->context_hash = context_hash;
+      cache->show_parameters = show_parameters;
+      std::set<std::string> parameter_rows;
+      for(unsigned i = 0; i < results->size(); ++i) {
+        auto result = results->get(i);
         if(result.available()) {
           std::string text;
-          if(show_parameters) {
+          if(cache->show_parameters) {
             class Recursive {
             public:
               static void f(const clangmm::CompletionString &completion_string, std::string &text) {
@@ -739,71 +918,68 @@ Source::ClangViewAutocomplete::ClangViewAutocomplete(const boost::filesystem::pa
               }
             };
             Recursive::f(result, text);
-            if(!text.empty()) {
-              bool already_added = false;
-              for(auto &row : autocomplete.rows) {
-                if(row == text) {
-                  already_added = true;
-                  break;
-                }
-              }
-              if(!already_added) {
-                autocomplete.rows.emplace_back(std::move(text));
-                completion_strings.emplace_back(result.cx_completion_string);
-              }
+            if(!text.empty() && parameter_rows.emplace(text).second) {
+              cache->rows.emplace_back(std::move(text));
+              cache->typed_texts.emplace_back();
+              cache->completion_strings.emplace_back(result.cx_completion_string);
             }
           }
           else {
             std::string return_text;
-            bool match = false;
+            std::string typed_text;
             for(unsigned i = 0; i < result.get_num_chunks(); ++i) {
               auto kind = static_cast<clangmm::CompletionChunkKind>(clang_getCompletionChunkKind(result.cx_completion_string, i));
               if(kind != clangmm::CompletionChunk_Informative) {
                 auto chunk_cstr = clangmm::String(clang_getCompletionChunkText(result.cx_completion_string, i));
-                if(kind == clangmm::CompletionChunk_TypedText) {
-                  if(strlen(chunk_cstr.c_str) >= prefix.size() && prefix.compare(0, prefix.size(), chunk_cstr.c_str, prefix.size()) == 0)
-                    match = true;
-                  else
-                    break;
-                }
+                if(kind == clangmm::CompletionChunk_TypedText)
+                  typed_text = chunk_cstr.c_str;
                 if(kind == clangmm::CompletionChunk_ResultType)
                   return_text = std::string("  →  ") + chunk_cstr.c_str;
                 else
                   text += chunk_cstr.c_str;
               }
             }
-            if(match && !text.empty()) {
+            if(!typed_text.empty() && !text.empty()) {
               if(!return_text.empty())
                 text += return_text;
-              autocomplete.rows.emplace_back(std::move(text));
-              completion_strings.emplace_back(result.cx_completion_string);
+              cache->rows.emplace_back(std::move(text));
+              cache->typed_texts.emplace_back(std::move(typed_text));
+              cache->completion_strings.emplace_back(result.cx_completion_string);
             }
           }
         }
       }
-      if(!show_parameters && enable_snippets) {
-        LockGuard lock(snippets_mutex);
-        if(snippets) {
-          for(auto &snippet : *snippets) {
-            if(prefix.compare(0, prefix.size(), snippet.prefix, 0, prefix.size()) == 0) {
-              autocomplete.rows.emplace_back(snippet.prefix);
-              completion_strings.emplace_back(nullptr);
-              snippet_inserts.emplace(autocomplete.rows.size() - 1, snippet.body);
-              snippet_comments.emplace(autocomplete.rows.size() - 1, snippet.description);
-            }
-          }
-        }
+      cache->results = std::move(results);
+      completion_cache = std::move(cache);
+    }
+
+    if(autocomplete.state == Autocomplete::State::STARTING) {
+      std::string prefix;
+      {
+        LockGuard lock(autocomplete.prefix_mutex);
+        prefix = autocomplete.prefix;
       }
+      add_completion_rows(prefix);
     }
   };
 
+  autocomplete.refilter_rows = [this] {
+    if(!completion_cache)
+      return;
+    std::string prefix;
+    {
+      LockGuard lock(autocomplete.prefix_mutex);
+      prefix = autocomplete.prefix;
+    }
+    add_completion_rows(prefix);
+  };
+
   autocomplete.on_show = [this] {
     hide_tooltips();
   };
 
   autocomplete.on_hide = [this] {
     selected_completion_string = nullptr;
-    code_complete_results = nullptr;
   };
 
   autocomplete.on_changed = [this](unsigned int index, const std::string &text) {
@@ -918,6 +1094,62 @@ Source::ClangViewAutocomplete::ClangViewAutocomplete(const boost::filesystem::pa
   };
 }
 
+void Source::ClangViewAutocomplete::add_completion_rows(const std::string &prefix) {
+  completion_strings.clear();
+  snippet_inserts.clear();
+  snippet_comments.clear();
+
+  auto &cache = *completion_cache;
+  auto prefix_lc = to_lower_case(prefix);
+  // When the prefix is extended, only the previous matches can match the new prefix
+  bool use_matches = cache.matches_set && prefix_lc.compare(0, cache.matches_prefix_lc.size(), cache.matches_prefix_lc) == 0;
+  auto size = use_matches ? cache.matches.size() : cache.rows.size();
+
+  std::vector<std::pair<int, size_t>> scores;
+  std::vector<size_t> matches;
+  for(size_t c = 0; c < size; ++c) {
+    auto index = use_matches ? cache.matches[c] : c;
+    auto score = cache.show_parameters ? 1 : fuzzy_match_score(prefix_lc, cache.typed_texts[index]);
+    if(score > 0) {
+      scores.emplace_back(score, index);
+      matches.emplace_back(index);
+    }
+  }
+  cache.matches = std::move(matches);
+  cache.matches_prefix_lc = std::move(prefix_lc);
+  cache.matches_set = true;
+
+  auto compare = [](const std::pair<int, size_t> &lhs, const std::pair<int, size_t> &rhs) {
+    return lhs.first > rhs.first || (lhs.first == rhs.first && lhs.second < rhs.second);
+  };
+  if(scores.size() > max_completion_rows) {
+    std::partial_sort(scores.begin(), scores.begin() + max_completion_rows, scores.end(), compare);
+    scores.resize(max_completion_rows);
+    autocomplete.rows_truncated = true;
+  }
+  else
+    std::sort(scores.begin(), scores.end(), compare);
+
+  for(auto &score : scores) {
+    autocomplete.rows.emplace_back(cache.rows[score.second]);
+    completion_strings.emplace_back(cache.completion_strings[score.second]);
+  }
+
+  if(!cache.show_parameters && enable_snippets) {
+    LockGuard lock(snippets_mutex);
+    if(snippets) {
+      for(auto &snippet : *snippets) {
+        if(prefix.compare(0, prefix.size(), snippet.prefix, 0, prefix.size()) == 0) {
+          autocomplete.rows.emplace_back(snippet.prefix);
+          completion_strings.emplace_back(nullptr);
+          snippet_inserts.emplace(autocomplete.rows.size() - 1, snippet.body);
+          snippet_comments.emplace(autocomplete.rows.size() - 1, snippet.description);
+        }
+      }
+    }
+  }
+}
+
 const std::unordered_map<std::string, std::string> &Source::ClangViewAutocomplete::autocomplete_manipulators_map() {
   //TODO: feel free to add more
   static std::unordered_map<std::string, std::string> map = {
@@ -963,8 +1195,10 @@ Source::ClangViewRefactor::ClangViewRefactor(const boost::filesystem::path &file
       translation_units.emplace_back(clang_tu.get());
       for(auto &view : views) {
         if(view != this) {
-          if(auto clang_view = dynamic_cast<Source::ClangView *>(view))
-            translation_units.emplace_back(clang_view->clang_tu.get());
+          if(auto clang_view = dynamic_cast<Source::ClangView *>(view)) {
+            if(clang_view->clang_tu)
+              translation_units.emplace_back(clang_view->clang_tu.get());
+          }
         }
       }
 
@@ -1210,6 +1444,8 @@ Source::ClangViewRefactor::ClangViewRefactor(const boost::filesystem::path &file
       auto identifier_usr = identifier.cursor.get_usr();
       for(auto &view : views) {
         if(auto clang_view = dynamic_cast<Source::ClangView *>(view)) {
+          if(!clang_view->clang_tokens)
+            continue;
           for(auto &token : *clang_view->clang_tokens) {
             auto cursor = token.get_cursor();
             auto cursor_kind = cursor.get_kind();
@@ -1347,7 +1583,8 @@ Source::ClangViewRefactor::ClangViewRefactor(const boost::filesystem::path &file
     auto iter = get_buffer()->get_insert()->get_iter();
     auto line = static_cast<unsigned>(iter.get_line());
     auto index = static_cast<unsigned>(iter.get_line_index());
-    for(size_t c = 0; c < clang_tokens->size(); ++c) {
+    auto token_indices = get_token_indices_at_line(line);
+    for(size_t c = token_indices.first; c < token_indices.second; ++c) {
       auto &token = (*clang_tokens)[c];
       if(token.is_identifier()) {
         auto &token_offsets = clang_tokens_offsets[c];
@@ -1430,8 +1667,10 @@ Source::ClangViewRefactor::ClangViewRefactor(const boost::filesystem::path &file
       translation_units.emplace_back(clang_tu.get());
       for(auto &view : views) {
         if(view != this) {
-          if(auto clang_view = dynamic_cast<Source::ClangView *>(view))
-            translation_units.emplace_back(clang_view->clang_tu.get());
+          if(auto clang_view = dynamic_cast<Source::ClangView *>(view)) {
+            if(clang_view->clang_tu)
+              translation_units.emplace_back(clang_view->clang_tu.get());
+          }
         }
       }
 
@@ -1459,7 +1698,8 @@ Source::ClangViewRefactor::ClangViewRefactor(const boost::filesystem::path &file
     auto iter = get_buffer()->get_insert()->get_iter();
     auto line = static_cast<unsigned>(iter.get_line());
     auto index = static_cast<unsigned>(iter.get_line_index());
-    for(size_t c = clang_tokens->size() - 1; c != static_cast<size_t>(-1); --c) {
+    auto token_indices = get_token_indices_at_line(line);
+    for(size_t c = token_indices.second - 1; c != token_indices.first - 1; --c) {
       auto &token = (*clang_tokens)[c];
       if(token.is_identifier()) {
         auto &token_offsets = clang_tokens_offsets[c];
@@ -1576,60 +1816,9 @@ Source::ClangViewRefactor::ClangViewRefactor(const boost::filesystem::path &file
   };
 
   get_methods = [this]() {
-    std::vector<std::pair<Offset, std::string>> methods;
     if(!parsed) {
       Info::get().print("Buffer is parsing");
-      return methods;
-    }
-    clangmm::Offset last_offset{static_cast<unsigned>(-1), static_cast<unsigned>(-1)};
-    for(auto &token : *clang_tokens) {
-      if(token.is_identifier()) {
-        auto cursor = token.get_cursor();
-        auto kind = cursor.get_kind();
-        if(kind == clangmm::Cursor::Kind::FunctionDecl || kind == clangmm::Cursor::Kind::CXXMethod ||
-           kind == clangmm::Cursor::Kind::Constructor || kind == clangmm::Cursor::Kind::Destructor ||
-           kind == clangmm::Cursor::Kind::FunctionTemplate || kind == clangmm::Cursor::Kind::ConversionFunction) {
-          auto offset = cursor.get_source_location().get_offset();
-          if(offset == last_offset)
-            continue;
-          last_offset = offset;
-
-          std::string method;
-          if(kind != clangmm::Cursor::Kind::Constructor && kind != clangmm::Cursor::Kind::Destructor) {
-            method += cursor.get_type().get_result().get_spelling();
-            auto pos = method.find(' ');
-            if(pos != std::string::npos)
-              method.erase(pos, 1);
-            method += " ";
-          }
-          method += cursor.get_display_name();
-
-          std::string prefix;
-          auto parent = cursor.get_semantic_parent();
-          while(parent && parent.get_kind() != clangmm::Cursor::Kind::TranslationUnit) {
-            prefix.insert(0, parent.get_display_name() + (prefix.empty() ? "" : "::"));
-            parent = parent.get_semantic_parent();
-          }
-
-          method = Glib::Markup::escape_text(method);
-          //Add bold method token
-          size_t token_end_pos = method.find('(');
-          if(token_end_pos == std::string::npos)
-            continue;
-          auto token_start_pos = token_end_pos;
-          while(token_start_pos != 0 && method[token_start_pos] != ' ')
-            --token_start_pos;
-          method.insert(token_end_pos, "</b>");
-          method.insert(token_start_pos, "<b>");
-
-          if(!prefix.empty())
-            prefix += ':';
-          prefix += std::to_string(offset.line) + ": ";
-          prefix = Glib::Markup::escape_text(prefix);
-
-          methods.emplace_back(Offset(offset.line - 1, offset.index - 1), prefix + method);
-        }
-      }
+      return std::vector<std::pair<Offset, std::string>>();
     }
     if(methods.empty())
       Info::get().print("No methods found in current buffer");
@@ -1763,7 +1952,8 @@ Source::ClangViewRefactor::Identifier Source::ClangViewRefactor::get_identifier(
   auto iter = get_buffer()->get_insert()->get_iter();
   auto line = static_cast<unsigned>(iter.get_line());
   auto index = static_cast<unsigned>(iter.get_line_index());
-  for(size_t c = clang_tokens->size() - 1; c != static_cast<size_t>(-1); --c) {
+  auto token_indices = get_token_indices_at_line(line);
+  for(size_t c = token_indices.second - 1; c != token_indices.first - 1; --c) {
     auto &token = (*clang_tokens)[c];
     if(token.is_identifier()) {
       auto &token_offsets = clang_tokens_offsets[c];
@@ -1782,7 +1972,7 @@ void Source::ClangViewRefactor::wait_parsing() {
   std::vector<Source::ClangView *> clang_views;
   for(auto &view : views) {
     if(auto clang_view = dynamic_cast<Source::ClangView *>(view)) {
-      if(!clang_view->parsed && !clang_view->selected_completion_string) {
+      if(!clang_view->parsed && !clang_view->selected_completion_string && clang_view->clang_tu) {
         clang_views.emplace_back(clang_view);
         if(!message)
           message = std::make_unique<Dialog::Message>("Please wait while all buffers finish parsing");
@@ -1812,11 +2002,23 @@ void Source::ClangViewRefactor::apply_similar_symbol_tag() {
   get_buffer()->remove_tag(similar_symbol_tag, get_buffer()->begin(), get_buffer()->end());
   auto identifier = get_identifier();
   if(identifier) {
-    auto offsets = clang_tokens->get_similar_token_offsets(identifier.kind, identifier.spelling, identifier.cursor.get_all_usr_extended());
-    for(auto &offset : offsets) {
-      auto start_iter = get_buffer()->get_iter_at_line_index(offset.first.line - 1, offset.first.index - 1);
-      auto end_iter = get_buffer()->get_iter_at_line_index(offset.second.line - 1, offset.second.index - 1);
-      get_buffer()->apply_tag(similar_symbol_tag, start_iter, end_iter);
+    auto it = clang_identifier_tokens.find(identifier.spelling);
+    if(it == clang_identifier_tokens.end())
+      return;
+    auto usrs = identifier.cursor.get_all_usr_extended();
+    for(auto c : it->second) {
+      auto referenced = (*clang_tokens)[c].get_cursor().get_referenced();
+      if(referenced && clangmm::Cursor::is_similar_kind(referenced.get_kind(), identifier.kind)) {
+        for(auto &usr : referenced.get_all_usr_extended()) {
+          if(usrs.count(usr)) {
+            auto &offsets = clang_tokens_offsets[c];
+            auto start_iter = get_buffer()->get_iter_at_line_index(offsets.first.line - 1, offsets.first.index - 1);
+            auto end_iter = get_buffer()->get_iter_at_line_index(offsets.second.line - 1, offsets.second.index - 1);
+            get_buffer()->apply_tag(similar_symbol_tag, start_iter, end_iter);
+            break;
+          }
+        }
+      }
     }
   }
 }
@@ -1827,7 +2029,8 @@ void Source::ClangViewRefactor::apply_clickable_tag(const Gtk::TextIter &iter) {
   auto line = static_cast<unsigned>(iter.get_line());
   auto index = static_cast<unsigned>(iter.get_line_index());
 
-  for(size_t c = clang_tokens->size() - 1; c != static_cast<size_t>(-1); --c) {
+  auto token_indices = get_token_indices_at_line(line);
+  for(size_t c = token_indices.second - 1; c != token_indices.first - 1; --c) {
     auto &token = (*clang_tokens)[c];
     if(token.is_identifier()) {
       auto &token_offsets = clang_tokens_offsets[c];
@@ -1853,8 +2056,8 @@ void Source::ClangViewRefactor::apply_clickable_tag(const Gtk::TextIter &iter) {
   }
 }
 
-Source::ClangView::ClangView(const boost::filesystem::path &file_path, const Glib::RefPtr<Gsv::Language> &language)
-    : BaseView(file_path, language), ClangViewParse(file_path, language), ClangViewAutocomplete(file_path, language), ClangViewRefactor(file_path, language) {
+Source::ClangView::ClangView(const boost::filesystem::path &file_path, const Glib::RefPtr<Gsv::Language> &language, bool delay_parse)
+    : BaseView(file_path, language), ClangViewParse(file_path, language, delay_parse), ClangViewAutocomplete(file_path, language), ClangViewRefactor(file_path, language) {
   if(language) {
     get_source_buffer()->set_highlight_syntax(true);
     get_source_buffer()->set_language(language);
@@ -1872,6 +2075,8 @@ void Source::ClangView::full_reparse() {
     Terminal::get().async_print("Error: failed to reparse " + file_path.string() + ". Please reopen the file manually.\n", true);
   };
   full_reparse_needed = false;
+  if(!clang_tu) // Parsing has not yet started
+    return;
   if(full_reparse_running) {
     print_error();
     return;
@@ -1916,6 +2121,12 @@ void Source::ClangView::async_delete() {
     }
   }
   Usages::Clang::erase_unused_caches(project_paths_in_use);
+
+  if(!clang_tu) { // Parsing never started, so there are no threads to wait for
+    delete this;
+    return;
+  }
+
   Usages::Clang::cache_in_progress();
 
   if(!get_buffer()->get_modified()) {
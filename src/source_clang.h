@@ -17,7 +17,8 @@ namespace Source {
     enum class ParseProcessState { IDLE, STARTING, PREPROCESSING, PROCESSING, POSTPROCESSING };
 
   public:
-    ClangViewParse(const boost::filesystem::path &file_path, const Glib::RefPtr<Gsv::Language> &language);
+    /// If delay_parse is true, parsing is postponed until the view is first shown
+    ClangViewParse(const boost::filesystem::path &file_path, const Glib::RefPtr<Gsv::Language> &language, bool delay_parse = false);
 
     void rename(const boost::filesystem::path &path) override;
     bool save() override;
@@ -28,15 +29,28 @@ namespace Source {
   protected:
     Dispatcher dispatcher;
     void parse_initialize();
+    sigc::connection delayed_parse_initialize_connection;
+    /// clang_tu is nullptr until parsing has started
     std::unique_ptr<clangmm::TranslationUnit> clang_tu;
     std::unique_ptr<clangmm::Tokens> clang_tokens;
     std::vector<std::pair<clangmm::Offset, clangmm::Offset>> clang_tokens_offsets;
+    /// Indices of the identifier tokens in clang_tokens, by spelling
+    std::unordered_map<std::string, std::vector<size_t>> clang_identifier_tokens;
+    /// Sets clang_tokens, clang_tokens_offsets and clang_identifier_tokens from clang_tu
+    void update_tokens();
+    /// Returns the index range [first, second) of the tokens in clang_tokens that start at the given 0-based line
+    std::pair<size_t, size_t> get_token_indices_at_line(unsigned line);
+    /// Incremented each time clang_tu is parsed
+    std::atomic<size_t> parse_count = {0};
     sigc::connection delayed_reparse_connection;
 
     void show_type_tooltips(const Gdk::Rectangle &rectangle) override;
 
     std::vector<FixIt> fix_its;
 
+    /// Functions and methods in this file with markup, updated after each successful reparse
+    std::vector<std::pair<Offset, std::string>> methods;
+
     Mutex parse_mutex;
     std::thread parse_thread;
     std::atomic<ParseState> parse_state;
@@ -45,7 +59,17 @@ namespace Source {
     CXCompletionString selected_completion_string = nullptr;
 
   private:
+    class LineCompare {
+    public:
+      bool operator()(const std::pair<clangmm::Offset, clangmm::Offset> &offsets, unsigned line) const { return offsets.first.line < line; }
+      bool operator()(unsigned line, const std::pair<clangmm::Offset, clangmm::Offset> &offsets) const { return line < offsets.first.line; }
+    };
+
     Glib::ustring parse_thread_buffer GUARDED_BY(parse_mutex);
+    std::string parse_thread_file_path GUARDED_BY(parse_mutex);
+    std::vector<std::pair<Offset, std::string>> parse_thread_methods GUARDED_BY(parse_mutex);
+    /// Creates parse_thread_methods from clang_tokens. Run in the parse thread.
+    void update_methods() REQUIRES(parse_mutex);
 
     static const std::map<int, std::string> &clang_types();
     void update_syntax() REQUIRES(parse_mutex);
@@ -53,6 +77,20 @@ namespace Source {
 
     void update_diagnostics() REQUIRES(parse_mutex);
     std::vector<clangmm::Diagnostic> clang_diagnostics GUARDED_BY(parse_mutex);
+    /// Hashes of clang_diagnostics, used to find diagnostics that are already shown
+    std::vector<size_t> clang_diagnostics_hashes GUARDED_BY(parse_mutex);
+    std::tuple<size_t, size_t, size_t> clang_diagnostics_status GUARDED_BY(parse_mutex);
+    /// Removes diagnostics of other files, and computes hashes and status. Run in the parse thread.
+    void process_diagnostics() REQUIRES(parse_mutex);
+
+    class DiagnosticTooltip {
+    public:
+      size_t hash;
+      bool error;
+      std::list<Tooltip>::iterator tooltip;
+    };
+    /// The diagnostics currently shown
+    std::vector<DiagnosticTooltip> diagnostic_tooltip_list;
   };
 
   class ClangViewAutocomplete : public virtual ClangViewParse {
@@ -61,7 +99,6 @@ namespace Source {
 
   protected:
     Autocomplete autocomplete;
-    std::unique_ptr<clangmm::CodeCompleteResults> code_complete_results;
     std::vector<CXCompletionString> completion_strings;
     sigc::connection delayed_show_arguments_connection;
 
@@ -72,6 +109,30 @@ namespace Source {
   private:
     std::atomic<bool> show_parameters = {false};
 
+    /// Code completion results are cached for a completion location and context,
+    /// and reused while the prefix changes
+    class CompletionCache {
+    public:
+      std::unique_ptr<clangmm::CodeCompleteResults> results;
+      size_t parse_count;
+      int line_number, column;
+      size_t context_hash;
+      bool show_parameters;
+
+      /// The available completions
+      std::vector<std::string> rows;
+      std::vector<std::string> typed_texts;
+      std::vector<CXCompletionString> completion_strings;
+
+      /// Indices of the completions that matched matches_prefix_lc
+      std::vector<size_t> matches;
+      std::string matches_prefix_lc;
+      bool matches_set = false;
+    };
+    std::unique_ptr<CompletionCache> completion_cache;
+    /// Adds the best matching rows from completion_cache, and snippets, to autocomplete.rows
+    void add_completion_rows(const std::string &prefix);
+
     const std::unordered_map<std::string, std::string> &autocomplete_manipulators_map();
   };
 
@@ -106,7 +167,7 @@ namespace Source {
 
   class ClangView : public ClangViewAutocomplete, public ClangViewRefactor {
   public:
-    ClangView(const boost::filesystem::path &file_path, const Glib::RefPtr<Gsv::Language> &language);
+    ClangView(const boost::filesystem::path &file_path, const Glib::RefPtr<Gsv::Language> &language, bool delay_parse = false);
 
     void full_reparse() override;
     void async_delete();
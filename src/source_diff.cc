@@ -3,7 +3,10 @@
 #include "filesystem.h"
 #include "info.h"
 #include "terminal.h"
+#include <algorithm>
 #include <boost/version.hpp>
+#include <limits>
+#include <unordered_map>
 
 Source::DiffView::Renderer::Renderer() : Gsv::GutterRenderer() {
   set_padding(4, 0);
@@ -12,22 +15,24 @@ Source::DiffView::Renderer::Renderer() : Gsv::GutterRenderer() {
 void Source::DiffView::Renderer::draw_vfunc(const Cairo::RefPtr<Cairo::Context> &cr, const Gdk::Rectangle &background_area,
                                             const Gdk::Rectangle &cell_area, Gtk::TextIter &start, Gtk::TextIter &end,
                                             Gsv::GutterRendererState p6) {
-  if(start.has_tag(tag_added) || end.has_tag(tag_added)) {
+  auto line = start.get_line();
+  auto line_state = line < static_cast<int>(line_states.size()) ? line_states[line] : 0;
+  if(line_state & ADDED) {
     cr->set_source_rgba(0.0, 1.0, 0.0, 0.5);
     cr->rectangle(cell_area.get_x(), cell_area.get_y(), 4, cell_area.get_height());
     cr->fill();
   }
-  else if(start.has_tag(tag_modified) || end.has_tag(tag_modified)) {
+  else if(line_state & MODIFIED) {
     cr->set_source_rgba(0.9, 0.9, 0.0, 0.75);
     cr->rectangle(cell_area.get_x(), cell_area.get_y(), 4, cell_area.get_height());
     cr->fill();
   }
-  if(start.has_tag(tag_removed_below) || end.has_tag(tag_removed_below)) {
+  if(line_state & REMOVED_BELOW) {
     cr->set_source_rgba(1.0, 0.0, 0.0, 0.5);
     cr->rectangle(cell_area.get_x() - 4, cell_area.get_y() + cell_area.get_height() - 2, 8, 2);
     cr->fill();
   }
-  if(start.has_tag(tag_removed_above) || end.has_tag(tag_removed_above)) {
+  if(line_state & REMOVED_ABOVE) {
     cr->set_source_rgba(1.0, 0.0, 0.0, 0.5);
     cr->rectangle(cell_area.get_x() - 4, cell_area.get_y(), 8, 2);
     cr->fill();
@@ -99,8 +104,22 @@ void Source::DiffView::configure() {
   parse_state = ParseState::STARTING;
   parse_stop = false;
   monitor_changed = false;
+  changed_start = changed_end_line_count = std::numeric_limits<int>::max();
+  update_all_lines = true;
 
   buffer_insert_connection = get_buffer()->signal_insert().connect([this](const Gtk::TextBuffer::iterator &iter, const Glib::ustring &text, int) {
+    changed_start = std::min(changed_start, iter.get_line());
+    changed_end_line_count = std::min(changed_end_line_count, get_buffer()->get_line_count() - 1 - iter.get_line());
+
+    // Move the line states along with the text until the lines are updated
+    auto newline_count = std::count(text.raw().begin(), text.raw().end(), '\n');
+    if(newline_count > 0) {
+      auto &line_states = renderer->line_states;
+      auto line = static_cast<size_t>(iter.starts_line() ? iter.get_line() : iter.get_line() + 1);
+      if(line <= line_states.size())
+        line_states.insert(line_states.begin() + line, newline_count, 0);
+    }
+
     //Do not perform git diff if no newline is added and line is already marked as added
     if(!iter.starts_line() && iter.has_tag(renderer->tag_added)) {
       bool newline = false;
@@ -120,6 +139,8 @@ void Source::DiffView::configure() {
       end_iter.forward_char();
       get_buffer()->remove_tag(renderer->tag_removed_above, start_iter, end_iter);
       get_buffer()->remove_tag(renderer->tag_removed_below, start_iter, end_iter);
+      if(static_cast<size_t>(iter.get_line()) < renderer->line_states.size())
+        renderer->line_states[iter.get_line()] &= ~(Renderer::REMOVED_ABOVE | Renderer::REMOVED_BELOW);
     }
     parse_state = ParseState::IDLE;
     delayed_buffer_changed_connection.disconnect();
@@ -130,6 +151,15 @@ void Source::DiffView::configure() {
   }, false);
 
   buffer_erase_connection = get_buffer()->signal_erase().connect([this](const Gtk::TextBuffer::iterator &start_iter, const Gtk::TextBuffer::iterator &end_iter) {
+    changed_start = std::min(changed_start, start_iter.get_line());
+    changed_end_line_count = std::min(changed_end_line_count, get_buffer()->get_line_count() - 1 - end_iter.get_line());
+
+    // Move the line states along with the text until the lines are updated
+    auto &line_states = renderer->line_states;
+    auto erase_start = std::min(static_cast<size_t>(start_iter.get_line() + 1), line_states.size());
+    auto erase_end = std::min(static_cast<size_t>(end_iter.get_line() + 1), line_states.size());
+    line_states.erase(line_states.begin() + erase_start, line_states.begin() + std::max(erase_start, erase_end));
+
     //Do not perform git diff if start_iter and end_iter is at the same line in addition to the line is tagged added
     if(start_iter.get_line() == end_iter.get_line() && start_iter.has_tag(renderer->tag_added))
       return;
@@ -163,6 +193,7 @@ void Source::DiffView::configure() {
       {
         LockGuard lock(parse_mutex);
         diff = get_diff();
+        set_old_buffer(diff->get_old_buffer());
       }
       status_branch = repository->get_branch();
     }
@@ -186,8 +217,12 @@ void Source::DiffView::configure() {
           dispatcher.post([this] {
             auto expected = ParseState::PREPROCESSING;
             if(parse_mutex.try_lock()) {
-              if(parse_state.compare_exchange_strong(expected, ParseState::PROCESSING))
+              if(parse_state.compare_exchange_strong(expected, ParseState::PROCESSING)) {
                 parse_buffer = get_buffer()->get_text();
+                parse_changed_start = changed_start;
+                parse_changed_end_line_count = changed_end_line_count;
+                changed_start = changed_end_line_count = std::numeric_limits<int>::max();
+              }
               parse_mutex.unlock();
             }
             else
@@ -199,6 +234,7 @@ void Source::DiffView::configure() {
           if(monitor_changed.compare_exchange_strong(expected_monitor_changed, false)) {
             try {
               diff = get_diff();
+              set_old_buffer(diff->get_old_buffer());
               dispatcher.post([this, status_branch = repository->get_branch()] {
                 this->status_branch = status_branch;
                 if(update_status_branch)
@@ -212,6 +248,7 @@ void Source::DiffView::configure() {
                 get_buffer()->remove_tag(renderer->tag_removed, get_buffer()->begin(), get_buffer()->end());
                 get_buffer()->remove_tag(renderer->tag_removed_below, get_buffer()->begin(), get_buffer()->end());
                 get_buffer()->remove_tag(renderer->tag_removed_above, get_buffer()->begin(), get_buffer()->end());
+                renderer->line_states.clear();
                 renderer->queue_draw();
                 this->status_branch = "";
                 if(update_status_branch)
@@ -219,12 +256,22 @@ void Source::DiffView::configure() {
               });
             }
           }
-          if(diff)
-            lines = diff->get_lines(parse_buffer.raw());
+          if(diff) {
+            if(update_all_hunks || !update_changed_hunks()) {
+              hunks = Git::Repository::Diff::get_hunks(old_buffer, parse_buffer.raw());
+              hunks_line_count = std::count(parse_buffer.raw().begin(), parse_buffer.raw().end(), '\n') + 1;
+              update_all_hunks = false;
+              update_lines_start = 0;
+              update_lines_end = std::numeric_limits<int>::max();
+            }
+            lines = Git::Repository::Diff::get_lines(hunks);
+          }
           else {
             lines.added.clear();
             lines.modified.clear();
             lines.removed.clear();
+            update_lines_start = 0;
+            update_lines_end = std::numeric_limits<int>::max();
           }
           auto expected = ParseState::PROCESSING;
           if(parse_state.compare_exchange_strong(expected, ParseState::POSTPROCESSING)) {
@@ -234,12 +281,18 @@ void Source::DiffView::configure() {
                 auto expected = ParseState::POSTPROCESSING;
                 if(parse_state.compare_exchange_strong(expected, ParseState::IDLE))
                   update_lines();
+                else
+                  update_all_lines = true;
                 parse_mutex.unlock();
               }
+              else
+                update_all_lines = true;
             });
           }
-          else
+          else {
+            update_all_lines = true;
             parse_mutex.unlock();
+          }
         }
       }
     }
@@ -250,6 +303,7 @@ void Source::DiffView::configure() {
         get_buffer()->remove_tag(renderer->tag_removed, get_buffer()->begin(), get_buffer()->end());
         get_buffer()->remove_tag(renderer->tag_removed_below, get_buffer()->begin(), get_buffer()->end());
         get_buffer()->remove_tag(renderer->tag_removed_above, get_buffer()->begin(), get_buffer()->end());
+        renderer->line_states.clear();
         renderer->queue_draw();
         Terminal::get().print(std::string("Error (git): ") + e_what + '\n', true);
       });
@@ -326,26 +380,209 @@ std::unique_ptr<Git::Repository::Diff> Source::DiffView::get_diff() {
   return std::make_unique<Git::Repository::Diff>(repository->get_diff(relative_path));
 }
 
+void Source::DiffView::set_old_buffer(std::string old_buffer_) {
+  old_buffer = std::move(old_buffer_);
+  old_line_offsets = {0};
+  for(size_t c = 0; c < old_buffer.size(); ++c) {
+    if(old_buffer[c] == '\n')
+      old_line_offsets.emplace_back(c + 1);
+  }
+  auto get_line = [this](size_t line) {
+    auto end = line + 1 < old_line_offsets.size() ? old_line_offsets[line + 1] : old_buffer.size();
+    return old_buffer.substr(old_line_offsets[line], end - old_line_offsets[line]);
+  };
+  std::unordered_map<std::string, size_t> line_counts;
+  for(size_t line = 0; line < old_line_offsets.size(); ++line)
+    ++line_counts[get_line(line)];
+  old_line_unique.clear();
+  old_line_unique.reserve(old_line_offsets.size());
+  for(size_t line = 0; line < old_line_offsets.size(); ++line)
+    old_line_unique.emplace_back(line_counts[get_line(line)] == 1);
+  update_all_hunks = true;
+}
+
+bool Source::DiffView::update_changed_hunks() {
+  auto &buffer = parse_buffer.raw();
+  int line_count = std::count(buffer.begin(), buffer.end(), '\n') + 1;
+  if(parse_changed_start == std::numeric_limits<int>::max()) {
+    update_lines_start = update_lines_end = 0;
+    return line_count == hunks_line_count;
+  }
+
+  // Changed lines in the previous parse_buffer
+  int line_count_change = line_count - hunks_line_count;
+  int changed_end = hunks_line_count - parse_changed_end_line_count;
+  if(changed_end < parse_changed_start || changed_end > hunks_line_count || changed_end + line_count_change < parse_changed_start)
+    return false;
+
+  // Zero-based first line of a hunk range, where an empty range is placed after its line number
+  auto first_line = [](const std::pair<int, int> &lines) {
+    return lines.second == 0 ? lines.first : lines.first - 1;
+  };
+
+  // Extend the window around the changed lines until the hunks it touches, and some unchanged lines around them, are included
+  const int context_lines = 3;
+  int window_start = std::max(parse_changed_start - context_lines, 0);
+  int window_end = std::min(changed_end + context_lines, hunks_line_count);
+  bool extended = true;
+  while(extended) {
+    extended = false;
+    for(auto &hunk : hunks) {
+      auto hunk_start = first_line(hunk.new_lines);
+      auto hunk_end = hunk_start + hunk.new_lines.second;
+      if(hunk_start <= window_end && hunk_end >= window_start) {
+        auto new_window_start = std::min(window_start, std::max(hunk_start - context_lines, 0));
+        auto new_window_end = std::max(window_end, std::min(hunk_end + context_lines, hunks_line_count));
+        if(new_window_start != window_start || new_window_end != window_end) {
+          window_start = new_window_start;
+          window_end = new_window_end;
+          extended = true;
+        }
+      }
+    }
+  }
+
+  // Lines outside of hunks are unchanged, and the window therefore starts and ends at unchanged lines in old_buffer as well
+  int old_window_start = window_start, old_window_end = window_end;
+  for(auto &hunk : hunks) {
+    auto hunk_start = first_line(hunk.new_lines);
+    if(hunk_start + hunk.new_lines.second < window_start) {
+      old_window_start -= hunk.new_lines.second - hunk.old_lines.second;
+      old_window_end -= hunk.new_lines.second - hunk.old_lines.second;
+    }
+    else if(hunk_start <= window_end)
+      old_window_end -= hunk.new_lines.second - hunk.old_lines.second;
+  }
+  if(old_window_start < 0 || old_window_end < old_window_start || old_window_end > static_cast<int>(old_line_offsets.size()))
+    return false;
+
+  auto get_old_offset = [this](int line) {
+    return line < static_cast<int>(old_line_offsets.size()) ? old_line_offsets[line] : old_buffer.size();
+  };
+  auto get_offset = [&buffer](int line) {
+    size_t offset = 0;
+    for(; line > 0; --line) {
+      auto pos = buffer.find('\n', offset);
+      if(pos == std::string::npos)
+        return buffer.size();
+      offset = pos + 1;
+    }
+    return offset;
+  };
+
+  // Among repeated lines, a full diff could align the window differently, so the first and last lines of the window must be unique in old_buffer
+  auto is_unique = [this](int line) {
+    return line >= 0 && line < static_cast<int>(old_line_unique.size()) && old_line_unique[line];
+  };
+  if((window_start > 0 && !is_unique(old_window_start)) || (window_end < hunks_line_count && !is_unique(old_window_end - 1)))
+    return false;
+
+  auto old_window_offset = get_old_offset(old_window_start);
+  auto window_offset = get_offset(window_start);
+  auto old_window = old_buffer.substr(old_window_offset, get_old_offset(old_window_end) - old_window_offset);
+  auto window = buffer.substr(window_offset, get_offset(window_end + line_count_change) - window_offset);
+  auto window_hunks = Git::Repository::Diff::get_hunks(old_window, window);
+
+  // Likewise for the unchanged lines between the hunks of the window
+  for(size_t c = 1; c < window_hunks.size(); ++c) {
+    auto end = first_line(window_hunks[c - 1].old_lines) + window_hunks[c - 1].old_lines.second;
+    for(auto line = end; line < first_line(window_hunks[c].old_lines); ++line) {
+      if(!is_unique(old_window_start + line))
+        return false;
+    }
+  }
+
+  auto get_lines = [](const std::string &text) {
+    std::vector<std::string> lines;
+    size_t offset = 0;
+    while(offset < text.size()) {
+      auto end = text.find('\n', offset);
+      end = end == std::string::npos ? text.size() : end + 1;
+      lines.emplace_back(text.substr(offset, end - offset));
+      offset = end;
+    }
+    return lines;
+  };
+  auto old_window_lines = get_lines(old_window), window_lines = get_lines(window);
+  // True if the lines of a hunk can be shifted across an equal line, which a full diff could have done differently
+  auto is_slidable = [](const std::vector<std::string> &lines, int start, int size) {
+    return size > 0 && ((start > 0 && lines[start - 1] == lines[start + size - 1]) ||
+                        (start + size < static_cast<int>(lines.size()) && lines[start] == lines[start + size]));
+  };
+
+  std::vector<Git::Repository::Diff::Hunk> new_hunks;
+  for(auto &hunk : hunks) {
+    if(first_line(hunk.new_lines) + hunk.new_lines.second < window_start)
+      new_hunks.emplace_back(hunk);
+  }
+  for(auto &hunk : window_hunks) {
+    // A hunk at the edge of the window could have had other lines in a full diff
+    auto old_start = first_line(hunk.old_lines);
+    auto new_start = first_line(hunk.new_lines);
+    if(window_start > 0 && (old_start == 0 || new_start == 0))
+      return false;
+    if(window_end < hunks_line_count && (old_start + hunk.old_lines.second == old_window_end - old_window_start ||
+                                         new_start + hunk.new_lines.second == window_end + line_count_change - window_start))
+      return false;
+    if(is_slidable(old_window_lines, old_start, hunk.old_lines.second) || is_slidable(window_lines, new_start, hunk.new_lines.second))
+      return false;
+    new_hunks.emplace_back(hunk.old_lines.first + old_window_start, hunk.old_lines.second, hunk.new_lines.first + window_start, hunk.new_lines.second);
+  }
+  for(auto &hunk : hunks) {
+    if(first_line(hunk.new_lines) > window_end)
+      new_hunks.emplace_back(hunk.old_lines.first, hunk.old_lines.second, hunk.new_lines.first + line_count_change, hunk.new_lines.second);
+  }
+
+  hunks = std::move(new_hunks);
+  hunks_line_count = line_count;
+  update_lines_start = window_start;
+  update_lines_end = window_end + line_count_change;
+  return true;
+}
+
 void Source::DiffView::update_lines() {
-  get_buffer()->remove_tag(renderer->tag_added, get_buffer()->begin(), get_buffer()->end());
-  get_buffer()->remove_tag(renderer->tag_modified, get_buffer()->begin(), get_buffer()->end());
-  get_buffer()->remove_tag(renderer->tag_removed, get_buffer()->begin(), get_buffer()->end());
-  get_buffer()->remove_tag(renderer->tag_removed_below, get_buffer()->begin(), get_buffer()->end());
-  get_buffer()->remove_tag(renderer->tag_removed_above, get_buffer()->begin(), get_buffer()->end());
+  auto start_line = update_lines_start;
+  auto end_line = update_lines_end;
+  if(update_all_lines.exchange(false)) {
+    start_line = 0;
+    end_line = std::numeric_limits<int>::max();
+  }
+  auto start = get_buffer()->get_iter_at_line(start_line);
+  auto end = end_line < get_buffer()->get_line_count() ? get_buffer()->get_iter_at_line(end_line) : get_buffer()->end();
+  get_buffer()->remove_tag(renderer->tag_added, start, end);
+  get_buffer()->remove_tag(renderer->tag_modified, start, end);
+  get_buffer()->remove_tag(renderer->tag_removed, start, end);
+  get_buffer()->remove_tag(renderer->tag_removed_below, start, end);
+  get_buffer()->remove_tag(renderer->tag_removed_above, start, end);
+
+  auto &line_states = renderer->line_states;
+  line_states.resize(get_buffer()->get_line_count(), 0);
+  std::fill(line_states.begin() + std::min(static_cast<size_t>(start_line), line_states.size()),
+            line_states.begin() + std::min(static_cast<size_t>(end_line), line_states.size()), 0);
 
   for(auto &added : lines.added) {
+    if(added.first < start_line || added.first >= end_line)
+      continue;
     auto start_iter = get_buffer()->get_iter_at_line(added.first);
     auto end_iter = get_iter_at_line_end(added.second - 1);
     end_iter.forward_char();
     get_buffer()->apply_tag(renderer->tag_added, start_iter, end_iter);
+    for(auto line = added.first; line < added.second && line < static_cast<int>(line_states.size()); ++line)
+      line_states[line] |= Renderer::ADDED;
   }
   for(auto &modified : lines.modified) {
+    if(modified.first < start_line || modified.first >= end_line)
+      continue;
     auto start_iter = get_buffer()->get_iter_at_line(modified.first);
     auto end_iter = get_iter_at_line_end(modified.second - 1);
     end_iter.forward_char();
     get_buffer()->apply_tag(renderer->tag_modified, start_iter, end_iter);
+    for(auto line = modified.first; line < modified.second && line < static_cast<int>(line_states.size()); ++line)
+      line_states[line] |= Renderer::MODIFIED;
   }
   for(auto &line_nr : lines.removed) {
+    if(line_nr + 1 < start_line || line_nr + 1 > end_line)
+      continue;
     Gtk::TextIter removed_start, removed_end;
     if(line_nr >= 0) {
       auto start_iter = get_buffer()->get_iter_at_line(line_nr);
@@ -354,6 +591,8 @@ void Source::DiffView::update_lines() {
       end_iter.forward_char();
       removed_end = end_iter;
       get_buffer()->apply_tag(renderer->tag_removed_below, start_iter, end_iter);
+      if(line_nr < static_cast<int>(line_states.size()))
+        line_states[line_nr] |= Renderer::REMOVED_BELOW;
     }
     if(line_nr + 1 < get_buffer()->get_line_count()) {
       auto start_iter = get_buffer()->get_iter_at_line(line_nr + 1);
@@ -363,6 +602,7 @@ void Source::DiffView::update_lines() {
       end_iter.forward_char();
       removed_end = end_iter;
       get_buffer()->apply_tag(renderer->tag_removed_above, start_iter, end_iter);
+      line_states[line_nr + 1] |= Renderer::REMOVED_ABOVE;
     }
     get_buffer()->apply_tag(renderer->tag_removed, removed_start, removed_end);
   }
@@ -8,6 +8,7 @@
 #include <map>
 #include <set>
 #include <thread>
+#include <vector>
 
 namespace Source {
   class DiffView : virtual public Source::BaseView {
@@ -23,6 +24,10 @@ namespace Source {
       Glib::RefPtr<Gtk::TextTag> tag_removed_below;
       Glib::RefPtr<Gtk::TextTag> tag_removed_above;
 
+      enum LineState : unsigned char { ADDED = 1, MODIFIED = 2, REMOVED_BELOW = 4, REMOVED_ABOVE = 8 };
+      /// LineState bits of each buffer line, set together with the tags above, so that drawing needs no tag lookups
+      std::vector<unsigned char> line_states;
+
     protected:
       void draw_vfunc(const Cairo::RefPtr<Cairo::Context> &cr, const Gdk::Rectangle &background_area,
                       const Gdk::Rectangle &cell_area, Gtk::TextIter &start, Gtk::TextIter &end,
@@ -66,7 +71,30 @@ namespace Source {
     sigc::connection delayed_monitor_changed_connection;
     std::atomic<bool> monitor_changed;
 
+    /// First changed line, and number of unchanged lines at the end, since the buffer was last copied to parse_buffer.
+    /// Only used in the main thread.
+    int changed_start, changed_end_line_count;
+    /// First changed line, and number of unchanged lines at the end, of parse_buffer compared to the previous parse_buffer
+    int parse_changed_start GUARDED_BY(parse_mutex), parse_changed_end_line_count GUARDED_BY(parse_mutex);
+
+    /// HEAD version of the file, and the start offset of each of its lines
+    std::string old_buffer GUARDED_BY(parse_mutex);
+    std::vector<size_t> old_line_offsets GUARDED_BY(parse_mutex);
+    /// True for the lines that occur only once in old_buffer
+    std::vector<bool> old_line_unique GUARDED_BY(parse_mutex);
+    /// Hunks between old_buffer and the previous parse_buffer
+    std::vector<Git::Repository::Diff::Hunk> hunks GUARDED_BY(parse_mutex);
+    int hunks_line_count GUARDED_BY(parse_mutex);
+    bool update_all_hunks GUARDED_BY(parse_mutex);
+    void set_old_buffer(std::string old_buffer_) REQUIRES(parse_mutex);
+    /// Diffs only the lines around the changed lines in parse_buffer, and returns false if a full diff is needed instead
+    bool update_changed_hunks() REQUIRES(parse_mutex);
+
     Git::Repository::Diff::Lines lines GUARDED_BY(parse_mutex);
+    /// Lines where the tags are updated, the lines of the changed hunks if not all lines are to be updated
+    int update_lines_start GUARDED_BY(parse_mutex), update_lines_end GUARDED_BY(parse_mutex);
+    /// Set if the tags of a previous update were not applied
+    std::atomic<bool> update_all_lines;
     void update_lines() REQUIRES(parse_mutex);
   };
 } // namespace Source
@@ -363,13 +363,20 @@ void LanguageProtocol::Client::handle_server_request(const std::string &method,
   }
 }
 
-Source::LanguageProtocolView::LanguageProtocolView(const boost::filesystem::path &file_path, const Glib::RefPtr<Gsv::Language> &language, std::string language_id_)
-    : Source::BaseView(file_path, language), Source::View(file_path, language), uri(filesystem::get_uri_from_path(file_path)), language_id(std::move(language_id_)), client(LanguageProtocol::Client::get(file_path, language_id)), autocomplete(this, interactive_completion, last_keyval, false) {
+Source::LanguageProtocolView::LanguageProtocolView(const boost::filesystem::path &file_path, const Glib::RefPtr<Gsv::Language> &language, std::string language_id_, bool delay_initialize)
+    : Source::BaseView(file_path, language), Source::View(file_path, language), uri(filesystem::get_uri_from_path(file_path)), language_id(std::move(language_id_)), autocomplete(this, interactive_completion, last_keyval, false) {
   configure();
   get_source_buffer()->set_language(language);
   get_source_buffer()->set_highlight_syntax(true);
 
-  initialize();
+  if(delay_initialize) {
+    delayed_initialize_connection = signal_map().connect([this] {
+      delayed_initialize_connection.disconnect();
+      initialize();
+    });
+  }
+  else
+    initialize();
 
   get_buffer()->signal_insert().connect([this](const Gtk::TextBuffer::iterator &start, const Glib::ustring &text_, int bytes) {
     std::string content_changes;
@@ -404,6 +411,8 @@ Source::LanguageProtocolView::LanguageProtocolView(const boost::filesystem::path
 }
 
 void Source::LanguageProtocolView::initialize() {
+  client = LanguageProtocol::Client::get(file_path, language_id);
+
   status_diagnostics = std::make_tuple(0, 0, 0);
   if(update_status_diagnostics)
     update_status_diagnostics(this);
@@ -447,6 +456,9 @@ void Source::LanguageProtocolView::close() {
   autocomplete_delayed_show_arguments_connection.disconnect();
   update_type_coverage_connection.disconnect();
 
+  if(!client) // Initialization has not yet started
+    return;
+
   if(initialize_thread.joinable())
     initialize_thread.join();
 
@@ -469,8 +481,8 @@ void Source::LanguageProtocolView::rename(const boost::filesystem::path &path) {
   dispatcher.reset();
   Source::DiffView::rename(path);
   uri = filesystem::get_uri_from_path(path);
-  client = LanguageProtocol::Client::get(file_path, language_id);
-  initialize();
+  if(!delayed_initialize_connection.connected())
+    initialize();
 }
 
 bool Source::LanguageProtocolView::save() {
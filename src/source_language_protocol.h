@@ -144,7 +144,8 @@ namespace LanguageProtocol {
 namespace Source {
   class LanguageProtocolView : public View {
   public:
-    LanguageProtocolView(const boost::filesystem::path &file_path, const Glib::RefPtr<Gsv::Language> &language, std::string language_id_);
+    /// If delay_initialize is true, initialization is postponed until the view is first shown
+    LanguageProtocolView(const boost::filesystem::path &file_path, const Glib::RefPtr<Gsv::Language> &language, std::string language_id_, bool delay_initialize = false);
     void initialize();
     void close();
     ~LanguageProtocolView() override;
@@ -165,6 +166,7 @@ namespace Source {
 
   private:
     bool initialized = false;
+    sigc::connection delayed_initialize_connection;
 
     std::string language_id;
     LanguageProtocol::Capabilities capabilities;
@@ -4,8 +4,8 @@
 #include "info.h"
 #include "notebook.h"
 #include "project.h"
+#include <cstring>
 #include <iostream>
-#include <regex>
 #include <thread>
 
 Terminal::Terminal() {
@@ -25,9 +25,9 @@ int Terminal::process(const std::string &command, const boost::filesystem::path
   std::unique_ptr<TinyProcessLib::Process> process;
   if(use_pipes)
     process = std::make_unique<TinyProcessLib::Process>(command, path.string(), [this](const char *bytes, size_t n) {
-      async_print(std::string(bytes, n));
+      add_pending_output(bytes, n, false);
     }, [this](const char *bytes, size_t n) {
-      async_print(std::string(bytes, n), true);
+      add_pending_output(bytes, n, true);
     });
   else
     process = std::make_unique<TinyProcessLib::Process>(command, path.string());
@@ -54,7 +54,7 @@ int Terminal::process(std::istream &stdin_stream, std::ostream &stdout_stream, c
     if(stderr_stream)
       stderr_stream->write(bytes, n);
     else
-      async_print(std::string(bytes, n), true);
+      add_pending_output(bytes, n, true);
   }, true);
 
   if(process.get_id() <= 0) {
@@ -83,10 +83,10 @@ void Terminal::async_process(const std::string &command, const boost::filesystem
     stdin_buffer.clear();
     auto process = std::make_shared<TinyProcessLib::Process>(command, path.string(), [this, quiet](const char *bytes, size_t n) {
       if(!quiet)
-        async_print(std::string(bytes, n));
+        add_pending_output(bytes, n, false);
     }, [this, quiet](const char *bytes, size_t n) {
       if(!quiet)
-        async_print(std::string(bytes, n), true);
+        add_pending_output(bytes, n, true);
     }, true);
     auto pid = process->get_id();
     if(pid <= 0) {
@@ -164,77 +164,224 @@ bool Terminal::on_motion_notify_event(GdkEventMotion *event) {
 }
 
 std::tuple<size_t, size_t, std::string, std::string, std::string> Terminal::find_link(const std::string &line) {
-  const static std::regex link_regex("^([A-Z]:)?([^:]+):([0-9]+):([0-9]+): .*$|"                      // C/C++ compile warning/error/rename usages
-                                     "^  --> ([A-Z]:)?([^:]+):([0-9]+):([0-9]+)$|"                    // Rust
-                                     "^Assertion failed: .*file ([A-Z]:)?([^:]+), line ([0-9]+)\\.$|" // clang assert()
-                                     "^[^:]*: ([A-Z]:)?([^:]+):([0-9]+): .* Assertion .* failed\\.$|" // gcc assert()
-                                     "^ERROR:([A-Z]:)?([^:]+):([0-9]+):.*$|"                          // g_assert (glib.h)
-                                     "^([A-Z]:)?([\\/][^:]+):([0-9]+)$|"                              // Node.js
-                                     "^  File \"([A-Z]:)?([^\"]+)\", line ([0-9]+), in .*$");         // Python
-  size_t start_position = -1, end_position = -1;
-  std::string path, line_number, line_offset;
-  std::smatch sm;
-  if(std::regex_match(line, sm, link_regex)) {
-    for(size_t sub = 1; sub < link_regex.mark_count();) {
-      size_t subs = sub == 1 || sub == 5 ? 4 : 3;
-      if(sm.length(sub + 1)) {
-        start_position = sm.position(sub + 1) - sm.length(sub);
-        end_position = sm.position(sub + subs - 1) + sm.length(sub + subs - 1);
-        if(sm.length(sub))
-          path += sm[sub].str();
-        path += sm[sub + 1].str();
-        line_number = sm[sub + 2].str();
-        line_offset = subs == 4 ? sm[sub + 3].str() : "1";
-        break;
-      }
-      sub += subs;
+  // Scans line once per format, and gives the same result as matching the whole line against the following regular expressions in order,
+  // where the first ([A-Z]:)? is an optional Windows drive that is part of the path:
+  //   ([A-Z]:)?([^:]+):([0-9]+):([0-9]+): .*                     C/C++ compile warning/error/rename usages
+  //   "  --> "([A-Z]:)?([^:]+):([0-9]+):([0-9]+)                 Rust
+  //   "Assertion failed: ".*"file "([A-Z]:)?([^:]+)", line "([0-9]+)\.   clang assert()
+  //   [^:]*": "([A-Z]:)?([^:]+):([0-9]+)": ".*" Assertion ".*" failed."  gcc assert()
+  //   "ERROR:"([A-Z]:)?([^:]+):([0-9]+):.*                       g_assert (glib.h)
+  //   ([A-Z]:)?(/[^:]+):([0-9]+)                                 Node.js
+  //   "  File \""([A-Z]:)?([^\"]+)"\", line "([0-9]+)", in ".*   Python
+  //   ([A-Z]:)?([^:]+)\(([0-9]+)(,([0-9]+))?"): ".*              MSVC compile warning/error
+  const auto npos = std::string::npos;
+  auto starts_with = [&line](size_t pos, const char *str) {
+    auto size = std::strlen(str);
+    return pos <= line.size() && line.compare(pos, size, str) == 0;
+  };
+  auto is_digit = [&line](size_t pos) {
+    return pos < line.size() && line[pos] >= '0' && line[pos] <= '9';
+  };
+  // Returns the end of the digits starting at pos, or npos if there are none
+  auto digits_end = [&line, &is_digit](size_t pos) {
+    if(!is_digit(pos))
+      return npos;
+    while(is_digit(pos))
+      ++pos;
+    return pos;
+  };
+  // Returns true if the rest of the line, starting at pos, can be matched by .*
+  auto any_to_end = [&line](size_t pos) {
+    return line.find_first_of("\r\n", pos) == npos;
+  };
+  auto has_drive = [&line](size_t pos) {
+    return pos + 1 < line.size() && line[pos] >= 'A' && line[pos] <= 'Z' && line[pos + 1] == ':';
+  };
+
+  size_t start_position, path_end, line_start, line_end, offset_start = npos, offset_end = npos;
+
+  // Matches ([A-Z]:)?([^:]+):([0-9]+) starting at pos
+  auto path_and_line = [&](size_t pos, bool drive) {
+    auto path_start = drive ? pos + 2 : pos;
+    path_end = line.find(':', path_start);
+    if(path_end == npos || path_end == path_start)
+      return false;
+    line_start = path_end + 1;
+    line_end = digits_end(line_start);
+    return line_end != npos;
+  };
+  // Matches :([0-9]+) starting at pos
+  auto line_offset = [&](size_t pos) {
+    if(!starts_with(pos, ":"))
+      return false;
+    offset_start = pos + 1;
+    offset_end = digits_end(offset_start);
+    return offset_end != npos;
+  };
+
+  // Tries the pattern with and without a drive, and sets start_position if matched
+  auto match = [&](size_t pos, const auto &pattern) {
+    offset_start = offset_end = npos;
+    if((has_drive(pos) && pattern(pos, true)) || pattern(pos, false)) {
+      start_position = pos;
+      return true;
+    }
+    return false;
+  };
+
+  auto compile_message = [&](size_t pos, bool drive) {
+    return path_and_line(pos, drive) && line_offset(line_end) && starts_with(offset_end, ": ") && any_to_end(offset_end + 2);
+  };
+  auto rust = [&](size_t pos, bool drive) {
+    return path_and_line(pos, drive) && line_offset(line_end) && offset_end == line.size();
+  };
+  auto clang_assert = [&](size_t pos, bool drive) {
+    auto path_start = drive ? pos + 2 : pos;
+    if(line.size() < 2 || line.back() != '.')
+      return false;
+    line_end = line.size() - 1;
+    line_start = line_end;
+    while(line_start > path_start && is_digit(line_start - 1))
+      --line_start;
+    if(line_start == line_end || line_start < path_start + 8 || line.compare(line_start - 7, 7, ", line ") != 0)
+      return false;
+    path_end = line_start - 7;
+    return line.find(':', path_start) >= path_end;
+  };
+  auto gcc_assert = [&](size_t pos, bool drive) {
+    if(!(path_and_line(pos, drive) && starts_with(line_end, ": ")))
+      return false;
+    auto rest = line_end + 2;
+    if(!any_to_end(rest) || line.size() < rest + 19 || line.compare(line.size() - 8, 8, " failed.") != 0)
+      return false;
+    auto assertion = line.find(" Assertion ", rest);
+    return assertion != npos && assertion + 11 <= line.size() - 8;
+  };
+  auto g_assert = [&](size_t pos, bool drive) {
+    return path_and_line(pos, drive) && starts_with(line_end, ":") && any_to_end(line_end + 1);
+  };
+  auto node = [&](size_t pos, bool drive) {
+    auto path_start = drive ? pos + 2 : pos;
+    if(path_start >= line.size() || line[path_start] != '/')
+      return false;
+    return path_and_line(pos, drive) && path_end > path_start + 1 && line_end == line.size();
+  };
+  auto python = [&](size_t pos, bool drive) {
+    auto path_start = drive ? pos + 2 : pos;
+    path_end = line.find('"', path_start);
+    if(path_end == npos || path_end == path_start || !starts_with(path_end, "\", line "))
+      return false;
+    line_start = path_end + 8;
+    line_end = digits_end(line_start);
+    return line_end != npos && starts_with(line_end, ", in ") && any_to_end(line_end + 5);
+  };
+
+  auto msvc = [&](size_t pos, bool drive) {
+    auto path_start = drive ? pos + 2 : pos;
+    auto colon = line.find(':', path_start);
+    if(colon == npos || colon < path_start + 4 || line[colon - 1] != ')' || !starts_with(colon, ": ") || !any_to_end(colon + 2))
+      return false;
+    // The line number, and the optional column, are parsed backwards from the )
+    line_end = colon - 1;
+    line_start = line_end;
+    while(line_start > path_start && is_digit(line_start - 1))
+      --line_start;
+    if(line_start == line_end || line_start == path_start)
+      return false;
+    if(line[line_start - 1] == ',') {
+      offset_start = line_start;
+      offset_end = line_end;
+      line_end = line_start - 1;
+      line_start = line_end;
+      while(line_start > path_start && is_digit(line_start - 1))
+        --line_start;
+      if(line_start == line_end)
+        return false;
     }
+    else
+      offset_start = offset_end = npos;
+    if(line_start < path_start + 2 || line[line_start - 1] != '(')
+      return false;
+    path_end = line_start - 1;
+    return true;
+  };
+
+  bool found = match(0, compile_message) ||
+               (starts_with(0, "  --> ") && match(6, rust));
+  if(!found && starts_with(0, "Assertion failed: ")) {
+    // The last "file " that gives a match is used, as with a greedy .*
+    auto any_end = line.find_first_of("\r\n", 18);
+    for(auto pos = line.rfind("file "); pos != npos && pos >= 18 && !found; pos = pos > 0 ? line.rfind("file ", pos - 1) : npos) {
+      if(any_end == npos || pos <= any_end)
+        found = match(pos + 5, clang_assert);
+    }
+  }
+  if(!found) {
+    auto colon = line.find(':');
+    found = (colon != npos && starts_with(colon, ": ") && match(colon + 2, gcc_assert)) ||
+            (starts_with(0, "ERROR:") && match(6, g_assert)) ||
+            match(0, node) ||
+            (starts_with(0, "  File \"") && match(8, python)) ||
+            match(0, msvc);
   }
-  return std::make_tuple(start_position, end_position, path, line_number, line_offset);
+  if(!found)
+    return std::make_tuple(static_cast<size_t>(-1), static_cast<size_t>(-1), std::string(), std::string(), std::string());
+
+  return std::make_tuple(start_position, offset_end != npos ? offset_end : line_end,
+                         line.substr(start_position, path_end - start_position),
+                         line.substr(line_start, line_end - line_start),
+                         offset_start != npos ? line.substr(offset_start, offset_end - offset_start) : std::string("1"));
 }
 
 void Terminal::apply_link_tags(const Gtk::TextIter &start_iter, const Gtk::TextIter &end_iter) {
-  auto iter = start_iter;
-  Gtk::TextIter line_start;
-  bool line_start_set = false;
-  bool delimiter_found = false;
-  bool dot_found = false;
-  bool number_found = false;
-  do {
-    if(iter.starts_line()) {
-      line_start = iter;
-      line_start_set = true;
-      delimiter_found = false;
-      dot_found = false;
-      number_found = false;
-    }
-    if(line_start_set && (*iter == '\\' || *iter == '/'))
-      delimiter_found = true;
-    else if(line_start_set && *iter == '.')
-      dot_found = true;
-    else if(line_start_set && (*iter >= '0' && *iter <= '9'))
-      number_found = true;
-    else if(line_start_set && delimiter_found && dot_found && number_found && iter.ends_line()) {
-      auto line = get_buffer()->get_text(line_start, iter);
-      //Convert to ascii for std::regex and Gtk::Iter::forward_chars
-      for(size_t c = 0; c < line.size(); ++c) {
-        if(line[c] > 127)
-          line.replace(c, 1, "a");
+  // Only lines that are complete are searched, one line at a time
+  auto line_start = start_iter;
+  while(line_start < end_iter) {
+    auto line_end = line_start;
+    if(!line_end.ends_line())
+      line_end.forward_to_line_end();
+    if(line_end >= end_iter)
+      break;
+
+    auto line = get_buffer()->get_text(line_start, line_end).raw();
+    if(auto diagnostic = build_diagnostics.add_line(line)) {
+      auto it = build_diagnostics.resolved_paths.find(diagnostic->path);
+      if(it == build_diagnostics.resolved_paths.end()) {
+        auto path = get_link_path(diagnostic->path);
+        it = build_diagnostics.resolved_paths.emplace(diagnostic->path, !path.empty() ? filesystem::get_normal_path(path).string() : diagnostic->path).first;
       }
-      auto link = find_link(line.raw());
+      diagnostic->path = it->second;
+      if(on_build_diagnostic)
+        on_build_diagnostic(*diagnostic);
+    }
+    // Links contain a path delimiter, a dot and a line number
+    if((line.find('/') != std::string::npos || line.find('\\') != std::string::npos) && line.find('.') != std::string::npos &&
+       line.find_first_of("0123456789") != std::string::npos) {
+      auto link = find_link(line);
       if(std::get<0>(link) != static_cast<size_t>(-1)) {
+        // The link positions are byte indices in the line
         auto link_start = line_start;
         auto link_end = line_start;
-        link_start.forward_chars(std::get<0>(link));
-        link_end.forward_chars(std::get<1>(link));
+        link_start.set_line_index(std::get<0>(link));
+        link_end.set_line_index(std::get<1>(link));
         get_buffer()->apply_tag(link_tag, link_start, link_end);
+        links[static_cast<size_t>(line_start.get_line()) + deleted_lines] = {std::move(std::get<2>(link)), std::move(std::get<3>(link)), std::move(std::get<4>(link))};
       }
-      line_start_set = false;
     }
-  } while(iter.forward_char() && iter != end_iter);
+
+    if(!line_start.forward_line())
+      break;
+  }
 }
 
 size_t Terminal::print(const std::string &message, bool bold) {
+  flush_pending_output();
+  insert(message, bold);
+  trim_history();
+  return static_cast<size_t>(get_buffer()->end().get_line()) + deleted_lines;
+}
+
+void Terminal::insert(const std::string &message, bool bold) {
 #ifdef _WIN32
   //Remove color codes
   auto message_no_color = message; //copy here since operations on Glib::ustring is too slow
@@ -281,20 +428,52 @@ size_t Terminal::print(const std::string &message, bool bold) {
   auto end_iter = get_buffer()->get_insert()->get_iter();
 
   apply_link_tags(start_iter, end_iter);
+}
 
+void Terminal::trim_history() {
   if(get_buffer()->get_line_count() > Config::get().terminal.history_size) {
     int lines = get_buffer()->get_line_count() - Config::get().terminal.history_size;
     get_buffer()->erase(get_buffer()->begin(), get_buffer()->get_iter_at_line(lines));
     deleted_lines += static_cast<size_t>(lines);
+    links.erase(links.begin(), links.lower_bound(deleted_lines));
   }
+}
 
-  return static_cast<size_t>(get_buffer()->end().get_line()) + deleted_lines;
+void Terminal::flush_pending_output() {
+  std::vector<std::pair<std::string, bool>> output;
+  {
+    LockGuard lock(pending_output_mutex);
+    output = std::move(pending_output);
+    pending_output.clear();
+    pending_output_flush_scheduled = false;
+  }
+  if(output.empty())
+    return;
+  for(auto &chunk : output)
+    insert(chunk.first, chunk.second);
+  trim_history();
 }
 
 void Terminal::async_print(const std::string &message, bool bold) {
-  dispatcher.post([message, bold] {
-    Terminal::get().print(message, bold);
-  });
+  add_pending_output(message.data(), message.size(), bold);
+}
+
+void Terminal::add_pending_output(const char *bytes, size_t n, bool bold) {
+  LockGuard lock(pending_output_mutex);
+  if(!pending_output.empty() && pending_output.back().second == bold)
+    pending_output.back().first.append(bytes, n);
+  else
+    pending_output.emplace_back(std::string(bytes, n), bold);
+  if(!pending_output_flush_scheduled) {
+    pending_output_flush_scheduled = true;
+    // Output that arrives within a frame is inserted together
+    dispatcher.post([this] {
+      Glib::signal_timeout().connect([this] {
+        flush_pending_output();
+        return false;
+      }, 16);
+    });
+  }
 }
 
 void Terminal::async_print(size_t line_nr, const std::string &message) {
@@ -337,7 +516,29 @@ void Terminal::configure() {
 }
 
 void Terminal::clear() {
+  {
+    LockGuard lock(pending_output_mutex);
+    pending_output.clear();
+  }
   get_buffer()->set_text("");
+  links.clear();
+}
+
+boost::filesystem::path Terminal::get_link_path(const std::string &link_path) {
+  auto path = filesystem::get_long_path(link_path);
+  if(path.is_relative()) {
+    if(!Project::current)
+      return boost::filesystem::path();
+    boost::system::error_code ec;
+    if(boost::filesystem::exists(Project::current->build->get_default_path() / path, ec))
+      return Project::current->build->get_default_path() / path;
+    if(boost::filesystem::exists(Project::current->build->get_debug_path() / path, ec))
+      return Project::current->build->get_debug_path() / path;
+    if(boost::filesystem::exists(Project::current->build->project_path / path, ec))
+      return Project::current->build->project_path / path;
+    return boost::filesystem::path();
+  }
+  return path;
 }
 
 bool Terminal::on_button_press_event(GdkEventButton *button_event) {
@@ -347,43 +548,23 @@ bool Terminal::on_button_press_event(GdkEventButton *button_event) {
     int location_x, location_y;
     window_to_buffer_coords(Gtk::TextWindowType::TEXT_WINDOW_TEXT, button_event->x, button_event->y, location_x, location_y);
     get_iter_at_location(iter, location_x, location_y);
-    if(iter.has_tag(link_tag)) {
-      auto start_iter = get_buffer()->get_iter_at_line(iter.get_line());
-      auto end_iter = start_iter;
-      while(!end_iter.ends_line() && end_iter.forward_char()) {
-      }
-      auto link = find_link(get_buffer()->get_text(start_iter, end_iter).raw());
-      if(std::get<0>(link) != static_cast<size_t>(-1)) {
-        auto path = filesystem::get_long_path(std::get<2>(link));
-        std::string line = std::get<3>(link);
-        std::string index = std::get<4>(link);
-
-        if(path.is_relative()) {
-          if(Project::current) {
-            if(boost::filesystem::exists(Project::current->build->get_default_path() / path))
-              path = Project::current->build->get_default_path() / path;
-            else if(boost::filesystem::exists(Project::current->build->get_debug_path() / path))
-              path = Project::current->build->get_debug_path() / path;
-            else if(boost::filesystem::exists(Project::current->build->project_path / path))
-              path = Project::current->build->project_path / path;
-            else
-              return Gtk::TextView::on_button_press_event(button_event);
+    auto link = links.find(static_cast<size_t>(iter.get_line()) + deleted_lines);
+    if(iter.has_tag(link_tag) && link != links.end()) {
+      auto path = get_link_path(link->second.path);
+      std::string line = link->second.line;
+      std::string index = link->second.line_offset;
+
+      if(!path.empty() && boost::filesystem::is_regular_file(path)) {
+        Notebook::get().open(path);
+        if(auto view = Notebook::get().get_current_view()) {
+          try {
+            int line_int = std::stoi(line) - 1;
+            int index_int = std::stoi(index) - 1;
+            view->place_cursor_at_line_index(line_int, index_int);
+            view->scroll_to_cursor_delayed(view, true, true);
+            return true;
           }
-          else
-            return Gtk::TextView::on_button_press_event(button_event);
-        }
-        if(boost::filesystem::is_regular_file(path)) {
-          Notebook::get().open(path);
-          if(auto view = Notebook::get().get_current_view()) {
-            try {
-              int line_int = std::stoi(line) - 1;
-              int index_int = std::stoi(index) - 1;
-              view->place_cursor_at_line_index(line_int, index_int);
-              view->scroll_to_cursor_delayed(view, true, true);
-              return true;
-            }
-            catch(...) {
-            }
+          catch(...) {
           }
         }
       }
@@ -1,4 +1,5 @@
 #pragma once
+#include "build_diagnostics.h"
 #include "dispatcher.h"
 #include "gtkmm.h"
 #include "mutex.h"
@@ -6,6 +7,7 @@
 #include <boost/filesystem.hpp>
 #include <functional>
 #include <iostream>
+#include <map>
 #include <tuple>
 
 class Terminal : public Gtk::TextView {
@@ -24,6 +26,7 @@ public:
   void kill_async_processes(bool force = false);
 
   size_t print(const std::string &message, bool bold = false);
+  /// Output is collected and inserted at most once per frame. Can be called from any thread.
   void async_print(const std::string &message, bool bold = false);
   void async_print(size_t line_nr, const std::string &message);
 
@@ -31,6 +34,11 @@ public:
 
   void clear();
 
+  /// Errors and warnings found in the output, cleared when a build starts
+  BuildDiagnostics build_diagnostics;
+  /// Called when an error or warning is found in the output, with the path made absolute if the file was found
+  std::function<void(const BuildDiagnostics::Diagnostic &diagnostic)> on_build_diagnostic;
+
 protected:
   bool on_motion_notify_event(GdkEventMotion *motion_event) override;
   bool on_button_press_event(GdkEventButton *button_event) override;
@@ -44,9 +52,34 @@ private:
   Glib::RefPtr<Gdk::Cursor> default_mouse_cursor;
   size_t deleted_lines = 0;
 
+  class Link {
+  public:
+    std::string path;
+    std::string line;
+    std::string line_offset;
+  };
+  /// Links found by apply_link_tags, by line number including the deleted lines
+  std::map<size_t, Link> links;
+
   std::tuple<size_t, size_t, std::string, std::string, std::string> find_link(const std::string &line);
+  /// Returns the path of a link, where relative paths are searched for in the build and project directories.
+  /// Returns an empty path if a relative path was not found.
+  boost::filesystem::path get_link_path(const std::string &link_path);
   void apply_link_tags(const Gtk::TextIter &start_iter, const Gtk::TextIter &end_iter);
 
+  void insert(const std::string &message, bool bold);
+  /// Removes the lines above the history size in one operation
+  void trim_history();
+  /// Adds output to be inserted on the next flush. Can be called from any thread.
+  void add_pending_output(const char *bytes, size_t n, bool bold);
+  /// Inserts the output that has not been inserted yet
+  void flush_pending_output();
+
+  Mutex pending_output_mutex;
+  /// Output chunks, and whether they are bold, where consecutive chunks with the same boldness are merged
+  std::vector<std::pair<std::string, bool>> pending_output GUARDED_BY(pending_output_mutex);
+  bool pending_output_flush_scheduled GUARDED_BY(pending_output_mutex) = false;
+
   Mutex processes_mutex;
   std::vector<std::shared_ptr<TinyProcessLib::Process>> processes GUARDED_BY(processes_mutex);
   Glib::ustring stdin_buffer;
@@ -47,9 +47,11 @@ public:
   void clear() { tooltip_list.clear(); };
 
   template <typename... Ts>
-  void emplace_back(Ts &&... params) {
+  std::list<Tooltip>::iterator emplace_back(Ts &&... params) {
     tooltip_list.emplace_back(std::forward<Ts>(params)...);
+    return std::prev(tooltip_list.end());
   }
+  void erase(std::list<Tooltip>::iterator it) { tooltip_list.erase(it); }
 
   std::function<void()> on_motion;
 
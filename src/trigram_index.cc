@@ -0,0 +1,184 @@
+#include "trigram_index.h"
+#include "filesystem.h"
+#include "project_files.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <thread>
+
+Mutex TrigramIndex::indices_mutex;
+std::map<boost::filesystem::path, TrigramIndex::Index> TrigramIndex::indices;
+const std::string TrigramIndex::index_header = "JUCI_TRIGRAM_INDEX 1\n";
+
+std::shared_ptr<const std::vector<std::string>> TrigramIndex::get_candidates(const boost::filesystem::path &project_path, const boost::filesystem::path &build_path,
+                                                                             const boost::filesystem::path &debug_path, const std::string &literal) {
+  if(literal.size() < 3)
+    return ProjectFiles::get_files(project_path, build_path, debug_path);
+
+  auto trigrams = get_trigrams(literal.data(), literal.size());
+  auto candidates = std::make_shared<std::vector<std::string>>();
+  LockGuard lock(indices_mutex);
+  auto &index = get_index(project_path, build_path, debug_path);
+  for(auto &file : index.files) {
+    bool contains_all = true;
+    for(auto trigram : trigrams) {
+      if(!std::binary_search(file.second.trigrams.begin(), file.second.trigrams.end(), trigram)) {
+        contains_all = false;
+        break;
+      }
+    }
+    if(contains_all)
+      candidates->emplace_back(file.first);
+  }
+  return candidates;
+}
+
+TrigramIndex::Index &TrigramIndex::get_index(const boost::filesystem::path &project_path, const boost::filesystem::path &build_path, const boost::filesystem::path &debug_path) {
+  auto &index = indices[project_path];
+  if(index.index_path.empty() && !build_path.empty()) {
+    index.index_path = build_path / ".juci_trigrams";
+    read_index(index);
+  }
+
+  // Calls function for each index in [0, size) using one thread per core
+  auto parallel_for = [](size_t size, const std::function<void(size_t)> &function) {
+    std::atomic<size_t> next(0);
+    auto worker = [&] {
+      size_t c;
+      while((c = next++) < size)
+        function(c);
+    };
+    auto thread_count = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u), size);
+    std::vector<std::thread> threads;
+    for(size_t c = 1; c < thread_count; ++c)
+      threads.emplace_back(worker);
+    worker();
+    for(auto &thread : threads)
+      thread.join();
+  };
+
+  // Find new and changed files
+  auto now = std::time(nullptr);
+  auto files = ProjectFiles::get_files(project_path, build_path, debug_path);
+  std::vector<std::time_t> last_write_times(files->size());
+  parallel_for(files->size(), [&](size_t c) {
+    boost::system::error_code ec;
+    last_write_times[c] = boost::filesystem::last_write_time(project_path / (*files)[c], ec);
+    if(ec)
+      last_write_times[c] = -1;
+  });
+  std::map<std::string, File> new_files;
+  std::vector<std::pair<boost::filesystem::path, File *>> changed_files;
+  for(size_t c = 0; c < files->size(); ++c) {
+    auto &relative_path = (*files)[c];
+    auto last_write_time = last_write_times[c];
+    if(last_write_time == -1)
+      continue;
+    auto it = index.files.find(relative_path);
+    if(it != index.files.end() && it->second.last_write_time == last_write_time)
+      new_files.emplace_hint(new_files.end(), relative_path, std::move(it->second));
+    else {
+      auto &file = new_files.emplace_hint(new_files.end(), relative_path, File())->second;
+      file.last_write_time = filesystem::get_stable_last_write_time(last_write_time, now);
+      changed_files.emplace_back(project_path / relative_path, &file);
+    }
+  }
+  bool changed = !changed_files.empty() || new_files.size() != index.files.size();
+
+  parallel_for(changed_files.size(), [&changed_files](size_t c) {
+    changed_files[c].second->trigrams = get_trigrams(changed_files[c].first);
+  });
+
+  index.files = std::move(new_files);
+  if(changed)
+    write_index(index);
+  return index;
+}
+
+void TrigramIndex::read_index(Index &index) {
+  std::ifstream stream(index.index_path.string(), std::ifstream::binary);
+  if(!stream)
+    return;
+  std::string header(index_header.size(), '\0');
+  if(!stream.read(&header[0], header.size()) || header != index_header)
+    return;
+
+  uint32_t path_size;
+  while(stream.read(reinterpret_cast<char *>(&path_size), sizeof(path_size))) {
+    std::string path(path_size, '\0');
+    int64_t last_write_time;
+    uint32_t trigrams_size;
+    if(!stream.read(&path[0], path_size) ||
+       !stream.read(reinterpret_cast<char *>(&last_write_time), sizeof(last_write_time)) ||
+       !stream.read(reinterpret_cast<char *>(&trigrams_size), sizeof(trigrams_size))) {
+      index.files.clear();
+      return;
+    }
+    auto &file = index.files[path];
+    file.last_write_time = last_write_time;
+    file.trigrams.resize(trigrams_size);
+    if(!stream.read(reinterpret_cast<char *>(file.trigrams.data()), trigrams_size * sizeof(uint16_t))) {
+      index.files.clear();
+      return;
+    }
+  }
+}
+
+void TrigramIndex::write_index(const Index &index) {
+  boost::system::error_code ec;
+  if(index.index_path.empty() || !boost::filesystem::is_directory(index.index_path.parent_path(), ec))
+    return;
+  std::ofstream stream(index.index_path.string(), std::ofstream::binary);
+  if(stream) {
+    stream.write(index_header.data(), index_header.size());
+    for(auto &file : index.files) {
+      uint32_t path_size = file.first.size();
+      int64_t last_write_time = file.second.last_write_time;
+      uint32_t trigrams_size = file.second.trigrams.size();
+      stream.write(reinterpret_cast<const char *>(&path_size), sizeof(path_size));
+      stream.write(file.first.data(), path_size);
+      stream.write(reinterpret_cast<const char *>(&last_write_time), sizeof(last_write_time));
+      stream.write(reinterpret_cast<const char *>(&trigrams_size), sizeof(trigrams_size));
+      stream.write(reinterpret_cast<const char *>(file.second.trigrams.data()), trigrams_size * sizeof(uint16_t));
+    }
+  }
+}
+
+std::vector<uint16_t> TrigramIndex::get_trigrams(const char *buffer, size_t size) {
+  // Hashes are marked in a bitmap first, which also sorts them and removes duplicates
+  std::vector<uint64_t> bitmap(65536 / 64, 0);
+  uint32_t trigram = 0;
+  for(size_t c = 0; c < size; ++c) {
+    trigram = ((trigram << 8) | static_cast<unsigned char>(std::tolower(static_cast<unsigned char>(buffer[c])))) & 0xffffff;
+    if(c >= 2) {
+      auto hash = TrigramIndex::hash(trigram);
+      bitmap[hash / 64] |= uint64_t(1) << (hash % 64);
+    }
+  }
+
+  std::vector<uint16_t> trigrams;
+  for(size_t c = 0; c < bitmap.size(); ++c) {
+    if(bitmap[c] == 0)
+      continue;
+    for(size_t bit = 0; bit < 64; ++bit) {
+      if((bitmap[c] >> bit) & 1)
+        trigrams.emplace_back(static_cast<uint16_t>(c * 64 + bit));
+    }
+  }
+  return trigrams;
+}
+
+std::vector<uint16_t> TrigramIndex::get_trigrams(const boost::filesystem::path &path) {
+  std::ifstream stream(path.string(), std::ifstream::binary);
+  if(!stream)
+    return {};
+  std::string buffer;
+  buffer.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+  // Binary files are not indexed, and are therefore never candidates
+  if(std::memchr(buffer.data(), '\0', std::min<size_t>(buffer.size(), 8192)))
+    return {};
+  return get_trigrams(buffer.data(), buffer.size());
+}
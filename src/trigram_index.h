@@ -0,0 +1,50 @@
+#pragma once
+#include "mutex.h"
+#include <boost/filesystem.hpp>
+#include <cstdint>
+#include <ctime>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+/// Index of the trigrams in the project files, used to find the files that may contain a string without reading them.
+/// The index is kept in memory, and in the build directory if any, and only files that have changed are read again.
+class TrigramIndex {
+public:
+  /// Returns the project files, relative to project_path and sorted, that may contain literal regardless of case.
+  /// All the project files are returned if literal is shorter than three characters.
+  static std::shared_ptr<const std::vector<std::string>> get_candidates(const boost::filesystem::path &project_path, const boost::filesystem::path &build_path,
+                                                                        const boost::filesystem::path &debug_path, const std::string &literal);
+
+private:
+  class File {
+  public:
+    std::time_t last_write_time;
+    /// Sorted hashes of the lowercase trigrams in the file. Hash collisions only add false candidates.
+    std::vector<uint16_t> trigrams;
+  };
+
+  class Index {
+  public:
+    /// Index file in the build directory, empty if the project has no build directory
+    boost::filesystem::path index_path;
+    /// Files by path relative to the project path
+    std::map<std::string, File> files;
+  };
+
+  const static std::string index_header;
+
+  static Mutex indices_mutex;
+  static std::map<boost::filesystem::path, Index> indices GUARDED_BY(indices_mutex);
+
+  /// Returns the index of project_path, where files that are new or have changed are read
+  static Index &get_index(const boost::filesystem::path &project_path, const boost::filesystem::path &build_path, const boost::filesystem::path &debug_path) REQUIRES(indices_mutex);
+  static void read_index(Index &index);
+  static void write_index(const Index &index);
+
+  static uint16_t hash(uint32_t trigram) { return static_cast<uint16_t>((trigram * 2654435761u) >> 16); }
+  /// Returns the sorted and unique hashes of the lowercase trigrams in buffer
+  static std::vector<uint16_t> get_trigrams(const char *buffer, size_t size);
+  static std::vector<uint16_t> get_trigrams(const boost::filesystem::path &path);
+};
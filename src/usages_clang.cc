@@ -3,6 +3,8 @@
 #include "config.h"
 #include "dialogs.h"
 #include "filesystem.h"
+#include "project_files.h"
+#include "trigram_index.h"
 #include "utility.h"
 #include <chrono>
 #include <fstream>
@@ -140,7 +142,18 @@ std::vector<Usages::Clang::Usages> Usages::Clang::get_usages(const boost::filesy
     return usages;
 
   auto paths = find_paths(project_path, build_path, debug_path);
-  auto pair = parse_paths(spelling, paths);
+  std::pair<std::map<boost::filesystem::path, PathSet>, PathSet> pair;
+  if(Config::get().project.trigram_index) {
+    PathSet spelling_paths;
+    for(auto &file : *TrigramIndex::get_candidates(project_path, build_path, debug_path, spelling)) {
+      auto path = project_path / file;
+      if(paths.count(path))
+        spelling_paths.emplace(std::move(path));
+    }
+    pair = parse_paths(spelling, paths, &spelling_paths);
+  }
+  else
+    pair = parse_paths(spelling, paths);
   PathSet all_cursors_paths;
   auto canonical = cursor.get_canonical();
   all_cursors_paths.emplace(canonical.get_source_location().get_path());
@@ -503,44 +516,44 @@ Usages::Clang::PathSet Usages::Clang::find_paths(const boost::filesystem::path &
                                                  const boost::filesystem::path &build_path, const boost::filesystem::path &debug_path) {
   PathSet paths;
 
-  CompileCommands compile_commands(build_path);
-
-  for(boost::filesystem::recursive_directory_iterator it(project_path), end; it != end; ++it) {
-    auto &path = it->path();
-    if(!boost::filesystem::is_regular_file(path)) {
-      if(path == build_path || path == debug_path || path.filename() == ".git")
-        it.no_push();
-      continue;
-    }
+  auto compile_commands = CompileCommands::get(build_path);
 
+  auto files = ProjectFiles::get_files(project_path, build_path, debug_path);
+  for(auto &file : *files) {
+    auto path = project_path / file;
     if(CompileCommands::is_header(path))
       paths.emplace(path);
-    else if(CompileCommands::is_source(path)) {
-      for(auto &command : compile_commands.commands) {
-        if(filesystem::get_normal_path(command.file) == path) {
-          paths.emplace(path);
-          break;
-        }
-      }
-    }
+    else if(CompileCommands::is_source(path) && !compile_commands->get_commands(path).empty())
+      paths.emplace(path);
   }
 
   return paths;
 }
 
-std::pair<std::map<boost::filesystem::path, Usages::Clang::PathSet>, Usages::Clang::PathSet> Usages::Clang::parse_paths(const std::string &spelling, const PathSet &paths) {
+std::pair<std::map<boost::filesystem::path, Usages::Clang::PathSet>, Usages::Clang::PathSet> Usages::Clang::parse_paths(const std::string &spelling, const PathSet &paths, const PathSet *spelling_paths) {
   std::map<boost::filesystem::path, PathSet> paths_includes;
   PathSet paths_with_spelling;
 
+  // Paths to read, where included paths are added if not all paths are read
+  std::vector<boost::filesystem::path> paths_to_read;
+  PathSet paths_to_read_set;
+  if(spelling_paths) {
+    paths_to_read.assign(spelling_paths->begin(), spelling_paths->end());
+    paths_to_read_set = *spelling_paths;
+  }
+  else
+    paths_to_read.assign(paths.begin(), paths.end());
+
   const static std::regex include_regex(R"R(^#[ \t]*include[ \t]*"([^"]+)".*$)R");
 
   auto is_spelling_char = [](char chr) {
     return (chr >= 'a' && chr <= 'z') || (chr >= 'A' && chr <= 'Z') || (chr >= '0' && chr <= '9') || chr == '_';
   };
 
-  for(auto &path : paths) {
+  for(size_t c = 0; c < paths_to_read.size(); ++c) {
+    auto path = paths_to_read[c];
     auto paths_includes_it = paths_includes.emplace(path, PathSet()).first;
-    bool check_spelling = !spelling.empty();
+    bool check_spelling = !spelling.empty() && (!spelling_paths || spelling_paths->count(path));
 
     std::ifstream stream(path.string(), std::ifstream::binary);
     if(!stream)
@@ -578,8 +591,11 @@ std::pair<std::map<boost::filesystem::path, Usages::Clang::PathSet>, Usages::Cla
           if(path_distance >= distance) {
             auto it = path.begin();
             std::advance(it, path_distance - distance);
-            if(std::equal(it, path.end(), include_path.begin(), include_path.end()))
+            if(std::equal(it, path.end(), include_path.begin(), include_path.end())) {
               paths_includes_it->second.emplace(path);
+              if(spelling_paths && paths_to_read_set.emplace(path).second)
+                paths_to_read.emplace_back(path);
+            }
           }
         }
       }
@@ -133,7 +133,9 @@ namespace Usages {
     static PathSet find_paths(const boost::filesystem::path &project_path,
                               const boost::filesystem::path &build_path, const boost::filesystem::path &debug_path);
 
-    static std::pair<std::map<boost::filesystem::path, PathSet>, PathSet> parse_paths(const std::string &spelling, const PathSet &paths);
+    /// Returns the includes of the paths that are read, and the paths that contain spelling.
+    /// If spelling_paths is set, only the paths in spelling_paths, and the paths they include recursively, are read.
+    static std::pair<std::map<boost::filesystem::path, PathSet>, PathSet> parse_paths(const std::string &spelling, const PathSet &paths, const PathSet *spelling_paths = nullptr);
 
     /// Recursively find and return all the include paths of path
     static PathSet get_all_includes(const boost::filesystem::path &path, const std::map<boost::filesystem::path, PathSet> &paths_includes);
@@ -1,6 +1,77 @@
 #include "utility.h"
+#include <algorithm>
 
 ScopeGuard::~ScopeGuard() {
   if(on_exit)
     on_exit();
 }
+
+std::string to_lower_case(std::string text) {
+  for(auto &chr : text) {
+    if(chr >= 'A' && chr <= 'Z')
+      chr += 'a' - 'A';
+  }
+  return text;
+}
+
+int fuzzy_match_score(const std::string &key_lc, const std::string &text) {
+  if(key_lc.empty())
+    return 1;
+
+  auto to_lower = [](char chr) {
+    return chr >= 'A' && chr <= 'Z' ? static_cast<char>(chr + ('a' - 'A')) : chr;
+  };
+  auto is_alnum = [](char chr) {
+    return (chr >= 'a' && chr <= 'z') || (chr >= 'A' && chr <= 'Z') || (chr >= '0' && chr <= '9') || static_cast<unsigned char>(chr) >= 128;
+  };
+
+  // Find the end of the first match
+  size_t key_pos = 0;
+  size_t end = std::string::npos;
+  for(size_t i = 0; i < text.size(); ++i) {
+    if(to_lower(text[i]) == key_lc[key_pos] && ++key_pos == key_lc.size()) {
+      end = i;
+      break;
+    }
+  }
+  if(end == std::string::npos)
+    return 0;
+
+  // Search backwards from end to find a shorter match
+  size_t start = 0;
+  key_pos = key_lc.size();
+  for(size_t i = end + 1; i-- > 0;) {
+    if(to_lower(text[i]) == key_lc[key_pos - 1] && --key_pos == 0) {
+      start = i;
+      break;
+    }
+  }
+
+  int score = 0;
+  key_pos = 0;
+  bool previous_matched = false;
+  bool in_gap = false;
+  for(size_t i = start; i <= end; ++i) {
+    if(key_pos < key_lc.size() && to_lower(text[i]) == key_lc[key_pos]) {
+      score += 16;
+      if(i == 0 || !is_alnum(text[i - 1]) || (text[i - 1] >= 'a' && text[i - 1] <= 'z' && text[i] >= 'A' && text[i] <= 'Z'))
+        score += 8; // Word start
+      if(previous_matched)
+        score += 8; // Consecutive characters
+      previous_matched = true;
+      in_gap = false;
+      ++key_pos;
+    }
+    else {
+      score -= in_gap ? 1 : 3;
+      previous_matched = false;
+      in_gap = true;
+    }
+  }
+  if(start == 0)
+    score += 8;
+  // Prefer shorter texts
+  score -= static_cast<int>(std::min<size_t>(text.size() - (end + 1 - start), 32) / 2);
+
+  return score > 0 ? score : 1;
+}
@@ -1,8 +1,18 @@
 #pragma once
 #include <functional>
+#include <string>
 
 class ScopeGuard {
 public:
   std::function<void()> on_exit;
   ~ScopeGuard();
 };
+
+/// Returns text with ASCII characters converted to lowercase
+std::string to_lower_case(std::string text);
+
+/// fzf-like fuzzy matching, where the characters of key_lc must be found in text in the same order,
+/// but not necessarily consecutively. The matching is case insensitive, and key_lc must be in lowercase.
+/// Returns 0 if there is no match, and a higher score for better matches,
+/// for instance when the matched characters are consecutive or at word starts.
+int fuzzy_match_score(const std::string &key_lc, const std::string &text);
@@ -7,12 +7,16 @@
 #include "directories.h"
 #include "entrybox.h"
 #include "filesystem.h"
+#include "grep.h"
 #include "info.h"
 #include "menu.h"
 #include "notebook.h"
 #include "project.h"
+#include "project_files.h"
 #include "selection_dialog.h"
 #include "terminal.h"
+#include "trigram_index.h"
+#include <thread>
 
 Window::Window() {
   Gsv::init();
@@ -75,6 +79,13 @@ Window::Window() {
       Project::debug_update_stop();
 #endif
   };
+  Terminal::get().on_build_diagnostic = [](const BuildDiagnostics::Diagnostic &diagnostic) {
+    for(auto view : Notebook::get().get_views()) {
+      if(view->file_path.string() == diagnostic.path)
+        view->add_build_diagnostic_mark(static_cast<int>(diagnostic.line) - 1, diagnostic.severity == BuildDiagnostics::Diagnostic::Severity::ERROR);
+    }
+  };
+
   Notebook::get().on_close_page = [](Source::View *view) {
 #ifdef JUCI_ENABLE_DEBUG
     if(Project::current && Project::debugging) {
@@ -618,6 +629,9 @@ void Window::set_menu_actions() {
   menu.add_action("edit_find", [this]() {
     search_and_replace_entry();
   });
+  menu.add_action("edit_find_in_project", [this]() {
+    find_in_project_entry();
+  });
 
   menu.add_action("source_spellcheck", []() {
     if(auto view = Notebook::get().get_current_view()) {
@@ -754,13 +768,12 @@ void Window::set_menu_actions() {
         return;
       }
     }
-    auto build = Project::Build::create(search_path);
-    auto project_path = build->project_path;
-    boost::filesystem::path default_path, debug_path;
-    if(!project_path.empty()) {
-      search_path = project_path;
-      default_path = build->get_default_path();
-      debug_path = build->get_debug_path();
+    auto pair = ProjectFiles::get_files(search_path);
+    search_path = std::move(pair.first);
+    auto files = std::move(pair.second);
+    if(files->empty()) {
+      Info::get().print("No files found in current project");
+      return;
     }
 
     if(view) {
@@ -774,34 +787,17 @@ void Window::set_menu_actions() {
     for(auto view : Notebook::get().get_views())
       buffer_paths.emplace(view->file_path.string());
 
-    std::vector<boost::filesystem::path> paths;
-    // populate with all files in search_path
-    for(boost::filesystem::recursive_directory_iterator iter(search_path), end; iter != end; iter++) {
-      auto path = iter->path();
-      // ignore folders
-      if(!boost::filesystem::is_regular_file(path)) {
-        if(path == default_path || path == debug_path || path.filename() == ".git")
-          iter.no_push();
-        continue;
-      }
-
-      // remove project base path
-      auto row_str = filesystem::get_relative_path(path, search_path).string();
-      if(buffer_paths.count(path.string()))
-        row_str = "<b>" + row_str + "</b>";
-      paths.emplace_back(path);
-      SelectionDialog::get()->add_row(row_str);
-    }
-
-    if(paths.empty()) {
-      Info::get().print("No files found in current project");
-      return;
+    for(auto &file : *files) {
+      if(buffer_paths.count((search_path / file).string()))
+        SelectionDialog::get()->add_row("<b>" + file + "</b>");
+      else
+        SelectionDialog::get()->add_row(file);
     }
 
-    SelectionDialog::get()->on_select = [paths = std::move(paths)](unsigned int index, const std::string &text, bool hide_window) {
-      if(index >= paths.size())
+    SelectionDialog::get()->on_select = [search_path = std::move(search_path), files = std::move(files)](unsigned int index, const std::string &text, bool hide_window) {
+      if(index >= files->size())
         return;
-      Notebook::get().open(paths[index]);
+      Notebook::get().open(search_path / (*files)[index]);
       if(auto view = Notebook::get().get_current_view())
         view->hide_tooltips();
     };
@@ -1173,6 +1169,31 @@ void Window::set_menu_actions() {
 
     Project::current->compile();
   });
+  auto goto_build_diagnostic = [](const BuildDiagnostics::Diagnostic *diagnostic) {
+    if(!diagnostic) {
+      Info::get().print("No build errors or warnings found");
+      return;
+    }
+    boost::system::error_code ec;
+    if(!boost::filesystem::is_regular_file(diagnostic->path, ec)) {
+      Info::get().print("Could not find " + diagnostic->path);
+      return;
+    }
+    Notebook::get().open(diagnostic->path);
+    if(auto view = Notebook::get().get_current_view()) {
+      view->place_cursor_at_line_index(static_cast<int>(diagnostic->line) - 1, static_cast<int>(diagnostic->line_offset) - 1);
+      view->scroll_to_cursor_delayed(view, true, false);
+      auto &build_diagnostics = Terminal::get().build_diagnostics;
+      Info::get().print(std::string(diagnostic->severity == BuildDiagnostics::Diagnostic::Severity::ERROR ? "Error " : "Warning ") +
+                        std::to_string(build_diagnostics.get_current() + 1) + '/' + std::to_string(build_diagnostics.diagnostics.size()) + ": " + diagnostic->message);
+    }
+  };
+  menu.add_action("project_goto_next_build_error", [goto_build_diagnostic]() {
+    goto_build_diagnostic(Terminal::get().build_diagnostics.next());
+  });
+  menu.add_action("project_goto_previous_build_error", [goto_build_diagnostic]() {
+    goto_build_diagnostic(Terminal::get().build_diagnostics.previous());
+  });
   menu.add_action("project_recreate_build", []() {
     if(Project::compiling || Project::debugging) {
       Info::get().print("Compile or debug in progress");
@@ -1657,6 +1678,145 @@ void Window::search_and_replace_entry() {
   EntryBox::get().show();
 }
 
+void Window::find_in_project_entry() {
+  EntryBox::get().clear();
+  EntryBox::get().labels.emplace_back();
+  auto label_it = EntryBox::get().labels.begin();
+
+  if(auto view = Notebook::get().get_current_view()) {
+    auto selected = view->get_selected_text();
+    if(!selected.empty())
+      last_find_in_project = selected;
+  }
+  EntryBox::get().entries.emplace_back(last_find_in_project, [this, label_it](const std::string &content) {
+    label_it->set_text("");
+    try {
+      find_in_project(content);
+    }
+    catch(const std::regex_error &) {
+      label_it->set_text("Invalid regular expression");
+    }
+  });
+  auto entry_it = EntryBox::get().entries.begin();
+  entry_it->set_placeholder_text("Find in Project");
+  entry_it->signal_changed().connect([this, entry_it]() {
+    last_find_in_project = entry_it->get_text();
+    if(find_in_project_canceled)
+      *find_in_project_canceled = true;
+  });
+
+  EntryBox::get().buttons.emplace_back("Find", [entry_it]() {
+    entry_it->activate();
+  });
+  EntryBox::get().buttons.back().set_tooltip_text("Find in Project\n\nShortcut: Enter in the entry field");
+
+  EntryBox::get().toggle_buttons.emplace_back("Aa");
+  EntryBox::get().toggle_buttons.back().set_tooltip_text("Match Case");
+  EntryBox::get().toggle_buttons.back().set_active(case_sensitive_search);
+  EntryBox::get().toggle_buttons.back().on_activate = [this]() {
+    case_sensitive_search = !case_sensitive_search;
+  };
+  EntryBox::get().toggle_buttons.emplace_back(".*");
+  EntryBox::get().toggle_buttons.back().set_tooltip_text("Use Regex");
+  EntryBox::get().toggle_buttons.back().set_active(regex_search);
+  EntryBox::get().toggle_buttons.back().on_activate = [this]() {
+    regex_search = !regex_search;
+  };
+  EntryBox::get().show();
+}
+
+void Window::find_in_project(const std::string &pattern) {
+  if(find_in_project_canceled)
+    *find_in_project_canceled = true;
+  if(pattern.empty())
+    return;
+  auto grep = std::make_shared<Grep>(pattern, case_sensitive_search, regex_search);
+
+  auto view = Notebook::get().get_current_view();
+  boost::filesystem::path search_path;
+  if(view)
+    search_path = view->file_path.parent_path();
+  else if(!Directories::get().path.empty())
+    search_path = Directories::get().path;
+  else {
+    boost::system::error_code ec;
+    search_path = boost::filesystem::current_path(ec);
+    if(ec) {
+      Terminal::get().print("Error: could not find current path\n", true);
+      return;
+    }
+  }
+
+  // The files are searched in separate threads, and the matches are added to the dialog as they are found
+  auto canceled = std::make_shared<std::atomic<bool>>(false);
+  find_in_project_canceled = canceled;
+  std::thread([this, grep = std::move(grep), search_path = std::move(search_path), canceled] {
+    auto paths = ProjectFiles::get_paths(search_path);
+    std::shared_ptr<const std::vector<std::string>> files;
+    if(Config::get().project.trigram_index)
+      files = TrigramIndex::get_candidates(paths.project_path, paths.build_path, paths.debug_path, grep->get_literal());
+    else
+      files = ProjectFiles::get_files(paths.project_path, paths.build_path, paths.debug_path);
+    auto project_path = std::make_shared<boost::filesystem::path>(std::move(paths.project_path));
+    auto rows = std::make_shared<std::vector<Source::Offset>>();
+    auto dialog = std::make_shared<SelectionDialog *>(nullptr);
+    grep->search(*project_path, *files, *canceled, [this, project_path, rows, dialog, canceled](std::vector<Grep::Location> &&locations) {
+      dispatcher.post([locations = std::move(locations), project_path, rows, dialog, canceled] {
+        if(*canceled)
+          return;
+        if(!*dialog) {
+          auto view = Notebook::get().get_current_view();
+          if(view) {
+            auto dialog_iter = view->get_iter_for_dialog();
+            SelectionDialog::create(view, view->get_buffer()->create_mark(dialog_iter), true, true);
+          }
+          else
+            SelectionDialog::create(true, true);
+          *dialog = SelectionDialog::get().get();
+
+          SelectionDialog::get()->on_hide = [canceled] {
+            *canceled = true;
+          };
+          SelectionDialog::get()->on_select = [project_path, rows](unsigned int index, const std::string &text, bool hide_window) {
+            if(index >= rows->size())
+              return;
+            auto &offset = (*rows)[index];
+            auto full_path = *project_path / offset.file_path;
+            if(!boost::filesystem::is_regular_file(full_path))
+              return;
+            Notebook::get().open(full_path);
+            auto view = Notebook::get().get_current_view();
+            view->place_cursor_at_line_index(offset.line, offset.index);
+            view->scroll_to_cursor_delayed(view, true, false);
+          };
+          if(view)
+            view->hide_tooltips();
+          SelectionDialog::get()->show();
+        }
+        else if(SelectionDialog::get().get() != *dialog) { // Another dialog has replaced the results dialog
+          *canceled = true;
+          return;
+        }
+
+        for(auto &location : locations) {
+          auto row = Glib::Markup::escape_text(location.file_path) + ':' + std::to_string(location.line + 1) + ": ";
+          if(Glib::ustring(location.source).validate()) {
+            row += Glib::Markup::escape_text(location.source.substr(0, location.index)) + "<b>" +
+                   Glib::Markup::escape_text(location.source.substr(location.index, location.length)) + "</b>" +
+                   Glib::Markup::escape_text(location.source.substr(location.index + location.length));
+          }
+          rows->emplace_back(location.line, location.index, location.file_path);
+          SelectionDialog::get()->add_row(row);
+        }
+      });
+    });
+    dispatcher.post([dialog, canceled] {
+      if(!*canceled && !*dialog)
+        Info::get().print("No matches found in current project");
+    });
+  }).detach();
+}
+
 void Window::set_tab_entry() {
   EntryBox::get().clear();
   if(auto view = Notebook::get().get_current_view()) {
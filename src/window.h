@@ -1,4 +1,5 @@
 #pragma once
+#include "dispatcher.h"
 #include <atomic>
 #include <boost/filesystem.hpp>
 #include <gtkmm.h>
@@ -29,6 +30,9 @@ private:
   void configure();
   void set_menu_actions();
   void search_and_replace_entry();
+  void find_in_project_entry();
+  /// Searches the project files in a separate thread, and adds the results to a SelectionDialog as they are found
+  void find_in_project(const std::string &pattern);
   void set_tab_entry();
   void goto_line_entry();
   void rename_token_entry();
@@ -39,4 +43,8 @@ private:
   bool case_sensitive_search = true;
   bool regex_search = false;
   bool search_entry_shown = false;
+  std::string last_find_in_project;
+  /// Set to true to stop the current Find in Project search
+  std::shared_ptr<std::atomic<bool>> find_in_project_canceled;
+  Dispatcher dispatcher;
 };
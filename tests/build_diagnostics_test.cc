@@ -0,0 +1,63 @@
+#include "build_diagnostics.h"
+#include <glib.h>
+
+int main() {
+  BuildDiagnostics build_diagnostics;
+  g_assert(!build_diagnostics.next());
+  g_assert(!build_diagnostics.add_line("[ 50%] Building CXX object CMakeFiles/test.dir/main.cpp.o"));
+  g_assert(!build_diagnostics.add_line("In file included from /home/test/main.cpp:1:"));
+  auto diagnostic = build_diagnostics.add_line("/home/test/main.cpp:7:41: error: expected ';' after expression");
+  g_assert(diagnostic);
+  g_assert(diagnostic->path == "/home/test/main.cpp");
+  g_assert(diagnostic->line == 7);
+  g_assert(diagnostic->line_offset == 41);
+  g_assert(diagnostic->severity == BuildDiagnostics::Diagnostic::Severity::ERROR);
+  g_assert(diagnostic->message == "expected ';' after expression");
+  g_assert(!build_diagnostics.add_line("/home/test/test.hpp:3:6: note: candidate function not viable"));
+  g_assert(!build_diagnostics.add_line("  a = 2"));
+  g_assert(build_diagnostics.diagnostics.size() == 1);
+  g_assert(build_diagnostics.diagnostics[0].notes.size() == 1);
+  g_assert(build_diagnostics.diagnostics[0].notes[0].path == "/home/test/test.hpp");
+  g_assert(build_diagnostics.diagnostics[0].notes[0].severity == BuildDiagnostics::Diagnostic::Severity::NOTE);
+
+  diagnostic = build_diagnostics.add_line("C:\\test\\main.cpp:12: warning: unused variable 'a' [-Wunused-variable]");
+  g_assert(diagnostic);
+  g_assert(diagnostic->path == "C:\\test\\main.cpp");
+  g_assert(diagnostic->line == 12);
+  g_assert(diagnostic->line_offset == 1);
+  g_assert(diagnostic->severity == BuildDiagnostics::Diagnostic::Severity::WARNING);
+  g_assert(diagnostic->message == "unused variable 'a' [-Wunused-variable]");
+
+  diagnostic = build_diagnostics.add_line("C:\\Program Files (x86)\\test\\main.cpp(10,5): error C2065: 'a': undeclared identifier");
+  g_assert(diagnostic);
+  g_assert(diagnostic->path == "C:\\Program Files (x86)\\test\\main.cpp");
+  g_assert(diagnostic->line == 10);
+  g_assert(diagnostic->line_offset == 5);
+  g_assert(diagnostic->message == "'a': undeclared identifier");
+
+  g_assert(!build_diagnostics.add_line("main.cpp:5:2: fatal error"));
+  diagnostic = build_diagnostics.add_line("main.cpp:5:2: fatal error: 'test.hpp' file not found");
+  g_assert(diagnostic);
+  g_assert(diagnostic->severity == BuildDiagnostics::Diagnostic::Severity::ERROR);
+
+  g_assert(!build_diagnostics.add_line("error[E0425]: cannot find value `a` in this scope"));
+  diagnostic = build_diagnostics.add_line("  --> src/main.rs:2:5");
+  g_assert(diagnostic);
+  g_assert(diagnostic->path == "src/main.rs");
+  g_assert(diagnostic->line == 2);
+  g_assert(diagnostic->line_offset == 5);
+  g_assert(diagnostic->message == "cannot find value `a` in this scope");
+  g_assert(!build_diagnostics.add_line("   --> src/main.rs:2:5"));
+  g_assert(!build_diagnostics.add_line("main.o:main.cpp:(.text+0x5): undefined reference to `f()'"));
+
+  g_assert(build_diagnostics.diagnostics.size() == 5);
+  g_assert(build_diagnostics.next() == &build_diagnostics.diagnostics[0]);
+  g_assert(build_diagnostics.next() == &build_diagnostics.diagnostics[1]);
+  g_assert(build_diagnostics.previous() == &build_diagnostics.diagnostics[0]);
+  g_assert(build_diagnostics.previous() == &build_diagnostics.diagnostics[4]);
+  g_assert(build_diagnostics.next() == &build_diagnostics.diagnostics[0]);
+
+  build_diagnostics.clear();
+  g_assert(build_diagnostics.diagnostics.empty());
+  g_assert(!build_diagnostics.previous());
+}
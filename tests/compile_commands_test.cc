@@ -1,4 +1,6 @@
 #include "compile_commands.h"
+#include "filesystem.h"
+#include <algorithm>
 #include <glib.h>
 
 int main() {
@@ -22,6 +24,22 @@ int main() {
     g_assert_cmpstr(parameter_values.at(0).c_str(), ==, "hello_lib@sta/main.cpp.o");
 
     g_assert(boost::filesystem::canonical(compile_commands.commands.at(0).file) == tests_path / "meson_test_files" / "main.cpp");
+
+    auto commands = compile_commands.get_commands(compile_commands.commands.at(0).file);
+    g_assert_cmpuint(commands.size(), ==, 2);
+    g_assert(commands.at(0) == &compile_commands.commands.at(0));
+    g_assert(commands.at(1) == &compile_commands.commands.at(1));
+    g_assert(compile_commands.get_commands(tests_path / "meson_test_files" / "build" / ".." / "not_a_source.cpp").empty());
+
+    auto &files = compile_commands.get_files(compile_commands.commands.at(0).file.parent_path());
+    g_assert(std::find(files.begin(), files.end(), filesystem::get_normal_path(compile_commands.commands.at(0).file)) != files.end());
+    g_assert(compile_commands.get_files(tests_path / "not_a_directory").empty());
+  }
+
+  {
+    auto compile_commands = CompileCommands::get(tests_path / "meson_test_files" / "build");
+    g_assert_cmpuint(compile_commands->commands.size(), ==, 5);
+    g_assert(CompileCommands::get(tests_path / "meson_test_files" / "build") == compile_commands);
   }
 
   {
@@ -0,0 +1,64 @@
+#include "ctags.h"
+#include "process.hpp"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <regex>
+#include <sstream>
+
+/// Compares the throughput of Ctags::parse_line with the regular expression it replaced.
+/// Usage: ctags_benchmark [tags file]
+/// Without a tags file, the tags of the juCi++ sources are read from ctags.
+int main(int argc, char *argv[]) {
+  const static std::regex regex(R"(^([^\t]+)\t([^\t]+)\t(?:/\^)?([ \t]*)(.+?)(\$/)?;"\tline:([0-9]+)\t?[a-zA-Z]*:?(.*)$)");
+
+  std::stringstream tags;
+  if(argc > 1) {
+    std::ifstream stream(argv[1], std::ios::binary);
+    if(!stream) {
+      std::cerr << "Could not open " << argv[1] << std::endl;
+      return 1;
+    }
+    tags << stream.rdbuf();
+  }
+  else {
+    TinyProcessLib::Process process("ctags --fields=ns --sort=no -I \"override noexcept\" -f - -R src", boost::filesystem::path(JUCI_TESTS_PATH).parent_path().string(), [&tags](const char *bytes, size_t n) {
+      tags.write(bytes, n);
+    });
+    if(process.get_exit_status() != 0) {
+      std::cerr << "Could not run ctags" << std::endl;
+      return 1;
+    }
+  }
+
+  std::vector<std::string> lines;
+  std::string line;
+  while(std::getline(tags, line)) {
+    if(!line.empty() && line[0] != '!')
+      lines.emplace_back(std::move(line));
+  }
+
+  using clock = std::chrono::steady_clock;
+  const size_t runs = 10;
+  size_t parsed_lines = 0;
+  auto start = clock::now();
+  Ctags::LineFields fields;
+  for(size_t c = 0; c < runs; ++c) {
+    for(auto &line : lines)
+      parsed_lines += Ctags::parse_line(line, fields) ? 1 : 0;
+  }
+  auto parse_line_seconds = std::chrono::duration<double>(clock::now() - start).count();
+
+  size_t regex_parsed_lines = 0;
+  start = clock::now();
+  std::smatch sm;
+  for(size_t c = 0; c < runs; ++c) {
+    for(auto &line : lines)
+      regex_parsed_lines += std::regex_match(line, sm, regex) ? 1 : 0;
+  }
+  auto regex_seconds = std::chrono::duration<double>(clock::now() - start).count();
+
+  std::cout << "Tags: " << lines.size() << " lines, " << parsed_lines / runs << " parsed by Ctags::parse_line, " << regex_parsed_lines / runs << " parsed by std::regex_match" << std::endl;
+  std::cout << "Ctags::parse_line: " << static_cast<size_t>(lines.size() * runs / parse_line_seconds) << " lines/second" << std::endl;
+  std::cout << "std::regex_match: " << static_cast<size_t>(lines.size() * runs / regex_seconds) << " lines/second" << std::endl;
+}
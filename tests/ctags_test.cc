@@ -0,0 +1,85 @@
+#include "ctags.h"
+#include <glib.h>
+#include <random>
+#include <regex>
+
+int main() {
+  const static std::regex regex(R"(^([^\t]+)\t([^\t]+)\t(?:/\^)?([ \t]*)(.+?)(\$/)?;"\tline:([0-9]+)\t?[a-zA-Z]*:?(.*)$)");
+
+  auto test_line = [](const std::string &line) {
+    std::smatch sm;
+    Ctags::LineFields fields;
+    auto parsed = Ctags::parse_line(line, fields);
+    g_assert(parsed == std::regex_match(line, sm, regex));
+    if(parsed) {
+      auto to_pair = [&sm](size_t group) {
+        return std::make_pair(static_cast<size_t>(sm.position(group)), static_cast<size_t>(sm.position(group) + sm.length(group)));
+      };
+      g_assert(fields.symbol == to_pair(1));
+      g_assert(fields.file == to_pair(2));
+      g_assert(fields.indentation == to_pair(3));
+      g_assert(fields.source == to_pair(4));
+      g_assert(fields.pattern_end == sm[5].matched);
+      g_assert(fields.line == to_pair(6));
+      g_assert(fields.scope == to_pair(7));
+    }
+  };
+
+  {
+    auto location = Ctags::get_location("main\tmain.cpp\t/^int main() {$/;\"\tline:3", false);
+    g_assert(location.symbol == "main");
+    g_assert(location.file_path == "main.cpp");
+    g_assert(location.source == "int main() {");
+    g_assert_cmpuint(location.line, ==, 2);
+    g_assert_cmpuint(location.index, ==, 4);
+    g_assert(location.scope.empty());
+  }
+  {
+    auto location = Ctags::get_location("method\tsrc/test.hpp\t/^  void method(int a);$/;\"\tline:10\tclass:Test", false);
+    g_assert(location.symbol == "method");
+    g_assert(location.file_path == "src/test.hpp");
+    g_assert(location.source == "void method(int a);");
+    g_assert_cmpuint(location.line, ==, 9);
+    g_assert_cmpuint(location.index, ==, 7);
+    g_assert(location.scope == "Test");
+  }
+  {
+    auto location = Ctags::get_location("operator +\ttest.cpp\t/^Test operator+(const Test &rhs);$/;\"\tline:5\tclass:Test", false);
+    g_assert(location.symbol == "operator+");
+    g_assert_cmpuint(location.index, ==, 5);
+  }
+  {
+    auto location = Ctags::get_location("MACRO\ttest.hpp\t1;\"\tline:1", false);
+    g_assert(location.symbol == "MACRO");
+    g_assert(location.source == "MACRO");
+    g_assert_cmpuint(location.index, ==, 0);
+  }
+
+  // Compare with the regular expression on random lines
+  std::mt19937 generator(0);
+  const std::string characters = "ab \t/^$;\":line:12\r";
+  std::uniform_int_distribution<size_t> character_distribution(0, characters.size() - 1);
+  std::uniform_int_distribution<size_t> size_distribution(0, 12);
+  std::vector<std::string> parts = {"/^", "$/", ";\"", "\tline:", "42", "\tclass:", "Test", "::", " ", "\t", "int a;", "\r"};
+  std::uniform_int_distribution<size_t> part_distribution(0, parts.size() - 1);
+  for(size_t c = 0; c < 100000; ++c) {
+    std::string line;
+    if(c % 2 == 0) {
+      auto size = size_distribution(generator) * 3;
+      for(size_t i = 0; i < size; ++i)
+        line += characters[character_distribution(generator)];
+    }
+    else {
+      line = "symbol\tfile.cpp\t";
+      auto size = size_distribution(generator) / 2;
+      for(size_t i = 0; i < size; ++i)
+        line += parts[part_distribution(generator)];
+      if(c % 3 != 0)
+        line += ";\"\tline:12";
+      size = size_distribution(generator) / 3;
+      for(size_t i = 0; i < size; ++i)
+        line += parts[part_distribution(generator)];
+    }
+    test_line(line);
+  }
+}
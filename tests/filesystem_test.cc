@@ -85,6 +85,12 @@ int main() {
     g_assert(filesystem::get_relative_path("/test2/test.cc", "/test/base") == boost::filesystem::path("..") / ".." / "test2" / "test.cc");
   }
 
+  {
+    g_assert(filesystem::get_stable_last_write_time(100, 102) == 100);
+    g_assert(filesystem::get_stable_last_write_time(101, 102) == 0);
+    g_assert(filesystem::get_stable_last_write_time(102, 102) == 0);
+  }
+
   {
     boost::filesystem::path path = "/ro ot/te stæøå.txt";
     auto uri = filesystem::get_uri_from_path(path);
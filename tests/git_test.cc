@@ -1,7 +1,10 @@
 #include "git.h"
+#include <atomic>
 #include <boost/filesystem.hpp>
+#include <fstream>
 #include <glib.h>
 #include <gtkmm.h>
+#include <thread>
 
 int main() {
   auto app = Gtk::Application::create();
@@ -23,6 +26,22 @@ int main() {
     g_assert_cmpuint(lines.added.size(), ==, 1);
     g_assert_cmpuint(lines.modified.size(), ==, 1);
     g_assert_cmpuint(lines.removed.size(), ==, 1);
+
+    // The HEAD blob is shared between diffs of the same file
+    auto diff2 = repository->get_diff((boost::filesystem::path("tests") / "git_test.cc"));
+    g_assert(diff2.get_old_buffer() == diff.get_old_buffer());
+    g_assert_cmpuint(diff2.get_lines("#include added\n#include \"git.h\"\n#include modified\n#include <glib.h>\n").added.size(), ==, 1);
+
+    for(size_t c = 0; c < 2; ++c) {
+      bool thrown = false;
+      try {
+        repository->get_diff(boost::filesystem::path("tests") / "not_a_file.cc");
+      }
+      catch(const std::exception &) {
+        thrown = true;
+      }
+      g_assert(thrown);
+    }
   }
   catch(const std::exception &e) {
     std::cerr << e.what() << std::endl;
@@ -55,4 +74,74 @@ int main() {
     assert(hunks[2].new_lines.first == 6);
     assert(hunks[2].new_lines.second == 2);
   }
+
+  // Status updated only for changed paths
+  {
+    auto work_path = boost::filesystem::canonical(boost::filesystem::temp_directory_path()) / boost::filesystem::unique_path();
+    boost::filesystem::create_directories(work_path);
+    git_repository *repository_ptr;
+    g_assert(git_repository_init(&repository_ptr, work_path.string().c_str(), false) == 0);
+    git_repository_free(repository_ptr);
+    {
+      auto repository = Git::get_repository(work_path);
+      std::ofstream(work_path.string() + "/a.txt") << "a";
+      auto status = repository->get_status();
+      g_assert(status.is_added(work_path / "a.txt"));
+      g_assert(!status.is_modified(work_path / "a.txt"));
+
+      boost::filesystem::create_directories(work_path / "b");
+      std::ofstream((work_path / "b" / "c.txt").string()) << "c";
+      g_assert(!repository->get_status().is_added(work_path / "b"));
+      repository->clear_saved_status(work_path / "b");
+      status = repository->get_status();
+      g_assert(status.is_added(work_path / "b"));
+      g_assert(status.is_added(work_path / "b" / "c.txt"));
+      g_assert(status.is_added(work_path / "a.txt"));
+
+      boost::filesystem::remove(work_path / "a.txt");
+      repository->clear_saved_status(work_path / "a.txt");
+      status = repository->get_status();
+      g_assert(!status.is_added(work_path / "a.txt"));
+      g_assert(status.is_added(work_path / "b" / "c.txt"));
+
+      // Changes outside the reported paths are found when the whole status is read again
+      boost::filesystem::create_directories(work_path / "d");
+      std::ofstream((work_path / "d" / "e.txt").string()) << "e";
+      g_assert(!repository->get_status().is_added(work_path / "d"));
+      repository->full_update_time -= repository->full_update_interval;
+      status = repository->get_status();
+      g_assert(status.is_added(work_path / "d"));
+      g_assert(status.is_added(work_path / "d" / "e.txt"));
+      g_assert(status.is_added(work_path / "b" / "c.txt"));
+    }
+    boost::filesystem::remove_all(work_path);
+  }
+
+  // Buffer diffs and repository calls from several threads
+  {
+    auto repository = Git::get_repository(tests_path);
+    auto diff = repository->get_diff((boost::filesystem::path("tests") / "git_test.cc"));
+    std::atomic<size_t> errors(0);
+    std::vector<std::thread> threads;
+    for(size_t c = 0; c < 4; ++c) {
+      threads.emplace_back([&] {
+        try {
+          for(size_t i = 0; i < 20; ++i) {
+            if(Git::Repository::Diff::get_hunks("line 1\nline 2\n", "line 1\nline 3\n").size() != 1)
+              ++errors;
+            if(diff.get_lines("#include added\n#include \"git.h\"\n").added.size() != 1)
+              ++errors;
+            repository->clear_saved_status();
+            repository->get_status();
+          }
+        }
+        catch(...) {
+          ++errors;
+        }
+      });
+    }
+    for(auto &thread : threads)
+      thread.join();
+    g_assert_cmpuint(errors, ==, 0);
+  }
 }
@@ -0,0 +1,93 @@
+#include "grep.h"
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <glib.h>
+
+int main() {
+  std::string buffer = "int main() {\n  int a = 0;\r\n  ++a;\n  return A;\n}";
+
+  {
+    Grep grep("a", true, false);
+    auto locations = grep.search(buffer.data(), buffer.size());
+    g_assert_cmpuint(locations.size(), ==, 3);
+    g_assert_cmpuint(locations[0].line, ==, 0);
+    g_assert_cmpuint(locations[0].index, ==, 5);
+    g_assert_cmpuint(locations[0].length, ==, 1);
+    g_assert(locations[0].source == "int main() {");
+    g_assert_cmpuint(locations[1].line, ==, 1);
+    g_assert_cmpuint(locations[1].index, ==, 6);
+    g_assert(locations[1].source == "  int a = 0;");
+    g_assert_cmpuint(locations[2].line, ==, 2);
+    g_assert_cmpuint(locations[2].index, ==, 4);
+  }
+  {
+    Grep grep("A", false, false);
+    auto locations = grep.search(buffer.data(), buffer.size());
+    g_assert_cmpuint(locations.size(), ==, 4);
+    g_assert_cmpuint(locations[3].line, ==, 3);
+    g_assert_cmpuint(locations[3].index, ==, 9);
+  }
+  {
+    Grep grep("RETURN", false, false);
+    auto locations = grep.search(buffer.data(), buffer.size());
+    g_assert_cmpuint(locations.size(), ==, 1);
+    g_assert_cmpuint(locations[0].line, ==, 3);
+    g_assert_cmpuint(locations[0].index, ==, 2);
+  }
+  {
+    Grep grep("int [a-z]+ = [0-9]", true, true);
+    auto locations = grep.search(buffer.data(), buffer.size());
+    g_assert_cmpuint(locations.size(), ==, 1);
+    g_assert_cmpuint(locations[0].line, ==, 1);
+    g_assert_cmpuint(locations[0].index, ==, 2);
+    g_assert_cmpuint(locations[0].length, ==, 9);
+  }
+  {
+    Grep grep("^\\}$", true, true);
+    auto locations = grep.search(buffer.data(), buffer.size());
+    g_assert_cmpuint(locations.size(), ==, 1);
+    g_assert_cmpuint(locations[0].line, ==, 4);
+  }
+  {
+    Grep grep("(main|return) ", false, true);
+    auto locations = grep.search(buffer.data(), buffer.size());
+    g_assert_cmpuint(locations.size(), ==, 1);
+    g_assert_cmpuint(locations[0].line, ==, 3);
+  }
+  try {
+    Grep grep("(", true, true);
+    g_assert(false);
+  }
+  catch(const std::regex_error &) {
+  }
+
+  g_assert(Grep::get_required_literal("int [a-z]+ = [0-9]") == "int ");
+  g_assert(Grep::get_required_literal("te?sting") == "sting");
+  g_assert(Grep::get_required_literal("(optional)?required") == "required");
+  g_assert(Grep::get_required_literal("a|b") == "");
+  g_assert(Grep::get_required_literal("\\.cc{1,2}$") == "c");
+
+  {
+    auto tests_path = boost::filesystem::canonical(JUCI_TESTS_PATH);
+    auto path = tests_path / "tmp" / "grep";
+    boost::filesystem::create_directories(path);
+    {
+      std::ofstream stream((path / "test.txt").string(), std::ofstream::binary);
+      stream << buffer;
+    }
+    {
+      std::ofstream stream((path / "test.bin").string(), std::ofstream::binary);
+      stream << std::string("\0return", 7);
+    }
+    Grep grep("return", true, false);
+    std::atomic<bool> canceled(false);
+    std::vector<Grep::Location> locations;
+    grep.search(path, {"test.txt", "test.bin", "missing.txt"}, canceled, [&locations](std::vector<Grep::Location> &&file_locations) {
+      locations.insert(locations.end(), file_locations.begin(), file_locations.end());
+    });
+    g_assert_cmpuint(locations.size(), ==, 1);
+    g_assert(locations[0].file_path == "test.txt");
+    g_assert_cmpuint(locations[0].line, ==, 3);
+    boost::filesystem::remove_all(path);
+  }
+}
@@ -0,0 +1,58 @@
+#include "git.h"
+#include "project_files.h"
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <glib.h>
+#include <gtkmm.h>
+
+int main() {
+  auto app = Gtk::Application::create();
+
+  // The project is a repository of its own, so that its .gitignore is used
+  auto project_path = boost::filesystem::canonical(boost::filesystem::temp_directory_path()) / boost::filesystem::unique_path();
+  boost::filesystem::create_directories(project_path / "src");
+  Git::initialize();
+  git_repository *repository;
+  g_assert(git_repository_init(&repository, project_path.string().c_str(), false) == 0);
+  git_repository_free(repository);
+  boost::filesystem::create_directories(project_path / "build");
+  boost::filesystem::create_directories(project_path / "ignored_directory");
+
+  auto write = [&project_path](const std::string &file, const std::string &content) {
+    std::ofstream stream((project_path / file).string(), std::ofstream::binary);
+    stream << content;
+  };
+  write(".gitignore", "ignored_directory\n*.o\n");
+  write("main.cpp", "");
+  write("main.o", "");
+  write("src/test.hpp", "");
+  write("build/build.cpp", "");
+  write("ignored_directory/test.cpp", "");
+
+  auto has_file = [](const std::shared_ptr<const std::vector<std::string>> &files, const std::string &file) {
+    return std::find(files->begin(), files->end(), file) != files->end();
+  };
+
+  {
+    auto files = ProjectFiles::get_files(project_path, project_path / "build", project_path / "build");
+    g_assert_cmpuint(files->size(), ==, 3);
+    g_assert(has_file(files, ".gitignore"));
+    g_assert(has_file(files, "main.cpp"));
+    g_assert(has_file(files, "src/test.hpp"));
+    g_assert(std::is_sorted(files->begin(), files->end()));
+  }
+
+  // Changes are found on the next call
+  {
+    write("src/test.cpp", "");
+    boost::filesystem::remove(project_path / "main.cpp");
+    auto files = ProjectFiles::get_files(project_path, project_path / "build", project_path / "build");
+    g_assert_cmpuint(files->size(), ==, 3);
+    g_assert(has_file(files, ".gitignore"));
+    g_assert(has_file(files, "src/test.cpp"));
+    g_assert(has_file(files, "src/test.hpp"));
+  }
+
+  boost::filesystem::remove_all(project_path);
+}
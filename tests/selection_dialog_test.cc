@@ -0,0 +1,148 @@
+#include "selection_dialog.h"
+#include "utility.h"
+#include <algorithm>
+#include <glib.h>
+#include <random>
+
+//Requires display server to work
+//However, it is possible to use the Broadway backend if the test is run in a pure terminal environment:
+//broadwayd&
+//make test
+
+int main() {
+  auto app = Gtk::Application::create();
+  // The dialog is placed relative to the active application window
+  app->register_application();
+  Gtk::Window window;
+  app->add_window(window);
+
+  std::vector<std::string> rows;
+  std::mt19937 generator(0);
+  auto get_row = [&generator] {
+    static const std::string characters = "abcdeABC_/.";
+    std::string row;
+    for(auto size = 5 + generator() % 20; size > 0; --size)
+      row += characters[generator() % characters.size()];
+    return row;
+  };
+
+  // Brute force ranking of all rows
+  auto get_expected_rows = [&rows](const std::string &key_lc) {
+    std::vector<std::pair<int, unsigned int>> results;
+    for(size_t c = 0; c < rows.size(); ++c) {
+      auto score = key_lc.empty() ? 1 : fuzzy_match_score(key_lc, to_lower_case(rows[c]));
+      if(score > 0)
+        results.emplace_back(key_lc.empty() ? 0 : -score, c);
+    }
+    std::sort(results.begin(), results.end());
+    std::vector<unsigned int> expected_rows;
+    for(auto &result : results)
+      expected_rows.emplace_back(result.second);
+    return expected_rows;
+  };
+
+  SelectionDialog::create(true, false);
+  auto &dialog = SelectionDialog::get();
+  auto wait = [&dialog] {
+    if(dialog->search_thread.joinable())
+      dialog->search_thread.join();
+    while(Gtk::Main::events_pending())
+      Gtk::Main::iteration(false);
+  };
+  auto add_row = [&dialog, &rows](std::string row) {
+    rows.emplace_back(row);
+    dialog->add_row(row);
+  };
+
+  // More rows than scored per chunk in the search thread
+  for(size_t c = 0; c < 3000; ++c)
+    add_row(get_row());
+  dialog->show();
+  auto &model = dialog->list_view_text.model;
+  g_assert(model->visible_rows == get_expected_rows(""));
+
+  dialog->search("a");
+  wait();
+  g_assert(model->visible_rows == get_expected_rows("a"));
+  g_assert(dialog->matches == model->visible_rows);
+
+  // Extended key, where only the previous matches are scored
+  dialog->search("aB");
+  wait();
+  g_assert(model->visible_rows == get_expected_rows("ab"));
+  g_assert(dialog->matches == model->visible_rows);
+
+  // Rows added while searching are scored when the search is done
+  dialog->search("ab_");
+  for(size_t c = 0; c < 500; ++c)
+    add_row(get_row());
+  wait();
+  g_assert(model->visible_rows == get_expected_rows("ab_"));
+  g_assert(dialog->matches == model->visible_rows);
+
+  // Rows added after a search are shown if they match the search key
+  for(size_t c = 0; c < 500; ++c)
+    add_row(get_row());
+  auto expected_rows = get_expected_rows("ab_");
+  g_assert(model->visible_rows.size() == expected_rows.size());
+  g_assert(std::is_permutation(model->visible_rows.begin(), model->visible_rows.end(), expected_rows.begin()));
+
+  // Shortened key, where all rows are scored
+  dialog->search("a");
+  wait();
+  g_assert(model->visible_rows == get_expected_rows("a"));
+
+  // Key without matches
+  dialog->search("a.a.a.a.a.a.a.a.a.a.a.a.a");
+  wait();
+  g_assert(model->visible_rows.empty());
+  g_assert(get_expected_rows("a.a.a.a.a.a.a.a.a.a.a.a.a").empty());
+
+  // Emptied key
+  dialog->search("");
+  wait();
+  g_assert(model->visible_rows == get_expected_rows(""));
+  g_assert(dialog->matches.empty());
+
+  // The results of a search are discarded when a newer search is started
+  dialog->search("c");
+  dialog->search_thread.join();
+  dialog->search("");
+  wait();
+  g_assert(model->visible_rows == get_expected_rows(""));
+  dialog->search("b");
+  dialog->search_thread.join();
+  dialog->search("d");
+  wait();
+  g_assert(model->visible_rows == get_expected_rows("d"));
+
+  // The tree model only exposes the visible rows, in order
+  {
+    auto &visible_rows = model->visible_rows;
+    g_assert(!visible_rows.empty());
+    auto tree_model = dialog->list_view_text.get_model();
+    g_assert_cmpuint(tree_model->children().size(), ==, visible_rows.size());
+    size_t position = 0;
+    for(auto it = tree_model->children().begin(); it != tree_model->children().end(); ++it) {
+      g_assert_cmpuint(position, <, visible_rows.size());
+      auto index = it->get_value(dialog->list_view_text.column_record.index);
+      g_assert_cmpuint(index, ==, visible_rows[position]);
+      g_assert(it->get_value(dialog->list_view_text.column_record.text) == rows[index]);
+      auto path = tree_model->get_path(it);
+      g_assert_cmpint(path.size(), ==, 1);
+      g_assert_cmpint(path[0], ==, position);
+      auto path_it = tree_model->get_iter(path);
+      g_assert(path_it);
+      g_assert_cmpuint(path_it->get_value(dialog->list_view_text.column_record.index), ==, index);
+      ++position;
+    }
+    g_assert_cmpuint(position, ==, visible_rows.size());
+    g_assert(!tree_model->get_iter(Gtk::TreeModel::Path(1, visible_rows.size())));
+    auto last_it = tree_model->get_iter(Gtk::TreeModel::Path(1, visible_rows.size() - 1));
+    g_assert(last_it);
+    g_assert(!++last_it);
+  }
+
+  dialog->hide();
+  dialog.reset();
+}
@@ -1,6 +1,9 @@
 #include "filesystem.h"
 #include "source.h"
 #include <glib.h>
+#include <limits>
+#include <random>
+#include <sstream>
 
 std::string hello_world = R"(#include <iostream>  
     
@@ -360,4 +363,106 @@ int main() {
       assert(source_view.get_selected_text() == "{\n    test;\n  }");
     }
   }
+
+  // DiffView::update_changed_hunks() tests
+  {
+    Source::View view(tests_path / "tmp" / "diff_file.cpp", Glib::RefPtr<Gsv::Language>());
+    auto buffer = view.get_buffer();
+    std::mt19937 generator(0);
+    // Among repeated lines, a full diff can align equal lines differently, also outside of the changed lines.
+    // The hunks must then describe the changes, but can differ from the hunks of a full diff.
+    for(bool repeated_lines : {false, true}) {
+      size_t line_number = 0;
+      auto get_line = [&generator, &line_number, repeated_lines]() -> std::string {
+        if(repeated_lines && generator() % 5 == 0)
+          return generator() % 2 == 0 ? "" : "}";
+        return "int variable" + std::to_string(line_number++) + ";";
+      };
+      size_t incremental_updates = 0;
+      for(size_t c = 0; c < 100; ++c) {
+        std::string old_buffer;
+        auto old_line_count = generator() % 100;
+        for(size_t line = 0; line < old_line_count; ++line)
+          old_buffer += get_line() + '\n';
+        if(generator() % 2 == 0)
+          old_buffer += get_line();
+        buffer->set_text(old_buffer);
+
+        LockGuard lock(view.parse_mutex);
+        view.set_old_buffer(old_buffer);
+        view.hunks.clear();
+        view.hunks_line_count = buffer->get_line_count();
+
+        for(size_t update = 0; update < 100; ++update) {
+          // Track the changed lines as in the buffer signal handlers of DiffView
+          int changed_start = std::numeric_limits<int>::max(), changed_end_line_count = std::numeric_limits<int>::max();
+          for(auto edits = generator() % 4; edits > 0; --edits) {
+            auto start = buffer->get_iter_at_offset(generator() % (buffer->get_char_count() + 1));
+            auto end = start;
+            if(generator() % 3 == 0)
+              end.forward_chars(generator() % 40);
+            std::string text;
+            if(generator() % 4 == 0)
+              text = "x";
+            else {
+              for(auto lines = generator() % 3; lines > 0; --lines)
+                text += generator() % 2 == 0 ? '\n' + get_line() : get_line() + '\n';
+            }
+            changed_start = std::min(changed_start, start.get_line());
+            changed_end_line_count = std::min(changed_end_line_count, buffer->get_line_count() - 1 - end.get_line());
+            start = buffer->erase(start, end);
+            buffer->insert(start, text);
+          }
+
+          view.parse_buffer = buffer->get_text();
+          view.parse_changed_start = changed_start;
+          view.parse_changed_end_line_count = changed_end_line_count;
+          auto hunks = Git::Repository::Diff::get_hunks(old_buffer, view.parse_buffer.raw());
+          if(view.update_changed_hunks()) {
+            if(!repeated_lines) {
+              g_assert_cmpuint(view.hunks.size(), ==, hunks.size());
+              for(size_t i = 0; i < hunks.size(); ++i) {
+                g_assert(view.hunks[i].old_lines == hunks[i].old_lines);
+                g_assert(view.hunks[i].new_lines == hunks[i].new_lines);
+              }
+            }
+            else {
+              // Replacing the old lines of each hunk with its new lines must give the new buffer
+              auto get_lines = [](const std::string &text) {
+                std::vector<std::string> lines;
+                std::stringstream stream(text);
+                std::string line;
+                while(std::getline(stream, line))
+                  lines.emplace_back(line + (stream.eof() ? "" : "\n"));
+                return lines;
+              };
+              auto old_lines = get_lines(old_buffer), new_lines = get_lines(view.parse_buffer.raw());
+              std::vector<std::string> lines;
+              int old_line = 0;
+              for(auto &hunk : view.hunks) {
+                auto old_start = hunk.old_lines.second == 0 ? hunk.old_lines.first : hunk.old_lines.first - 1;
+                auto new_start = hunk.new_lines.second == 0 ? hunk.new_lines.first : hunk.new_lines.first - 1;
+                g_assert_cmpint(old_start, >=, old_line);
+                g_assert_cmpint(old_start + hunk.old_lines.second, <=, old_lines.size());
+                lines.insert(lines.end(), old_lines.begin() + old_line, old_lines.begin() + old_start);
+                g_assert_cmpint(lines.size(), ==, new_start);
+                g_assert_cmpint(new_start + hunk.new_lines.second, <=, new_lines.size());
+                lines.insert(lines.end(), new_lines.begin() + new_start, new_lines.begin() + new_start + hunk.new_lines.second);
+                old_line = old_start + hunk.old_lines.second;
+              }
+              lines.insert(lines.end(), old_lines.begin() + old_line, old_lines.end());
+              g_assert(lines == new_lines);
+            }
+            g_assert_cmpint(view.hunks_line_count, ==, buffer->get_line_count());
+            ++incremental_updates;
+          }
+          else {
+            view.hunks = std::move(hunks);
+            view.hunks_line_count = buffer->get_line_count();
+          }
+        }
+      }
+      g_assert(incremental_updates > 0);
+    }
+  }
 }
@@ -11,6 +11,10 @@ void SelectionDialogBase::hide() {}
 
 void SelectionDialogBase::add_row(const std::string &row) {}
 
+void SelectionDialogBase::erase_rows() {}
+
+void SelectionDialogBase::set_cursor_at_first_row() {}
+
 std::unique_ptr<SelectionDialog> SelectionDialog::instance;
 
 SelectionDialog::SelectionDialog(Gtk::TextView *text_view, const Glib::RefPtr<Gtk::TextBuffer::Mark> &start_mark, bool show_search_entry, bool use_markup)
@@ -18,6 +22,12 @@ SelectionDialog::SelectionDialog(Gtk::TextView *text_view, const Glib::RefPtr<Gt
 
 SelectionDialogBase::~SelectionDialogBase() {}
 
+SelectionDialog::~SelectionDialog() {}
+
+void SelectionDialog::add_row(const std::string &row) {}
+
+void SelectionDialog::erase_rows() {}
+
 bool SelectionDialog::on_key_press(GdkEventKey *key) { return true; }
 
 std::unique_ptr<CompletionDialog> CompletionDialog::instance;
@@ -25,6 +35,8 @@ std::unique_ptr<CompletionDialog> CompletionDialog::instance;
 CompletionDialog::CompletionDialog(Gtk::TextView *text_view, const Glib::RefPtr<Gtk::TextBuffer::Mark> &start_mark)
     : SelectionDialogBase(text_view, start_mark, false, false) {}
 
+void CompletionDialog::add_row(const std::string &row) {}
+
 bool CompletionDialog::on_key_press(GdkEventKey *key) { return true; }
 
 bool CompletionDialog::on_key_release(GdkEventKey *key) { return true; }
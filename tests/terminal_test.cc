@@ -1,11 +1,48 @@
 #include "terminal.h"
 #include <glib.h>
+#include <random>
+#include <regex>
 
 //Requires display server to work
 //However, it is possible to use the Broadway backend if the test is run in a pure terminal environment:
 //broadwayd&
 //make test
 
+// The regular expressions that Terminal::find_link replaced, followed by the MSVC format that was added later, used to test that the results are the same
+std::tuple<size_t, size_t, std::string, std::string, std::string> find_link_regex(const std::string &line) {
+  const static std::regex link_regex("^([A-Z]:)?([^:]+):([0-9]+):([0-9]+): .*$|"                      // C/C++ compile warning/error/rename usages
+                                     "^  --> ([A-Z]:)?([^:]+):([0-9]+):([0-9]+)$|"                    // Rust
+                                     "^Assertion failed: .*file ([A-Z]:)?([^:]+), line ([0-9]+)\\.$|" // clang assert()
+                                     "^[^:]*: ([A-Z]:)?([^:]+):([0-9]+): .* Assertion .* failed\\.$|" // gcc assert()
+                                     "^ERROR:([A-Z]:)?([^:]+):([0-9]+):.*$|"                          // g_assert (glib.h)
+                                     "^([A-Z]:)?([\\/][^:]+):([0-9]+)$|"                              // Node.js
+                                     "^  File \"([A-Z]:)?([^\"]+)\", line ([0-9]+), in .*$|"          // Python
+                                     "^([A-Z]:)?([^:]+)\\(([0-9]+)(?:,([0-9]+))?\\): .*$");           // MSVC
+  size_t start_position = -1, end_position = -1;
+  std::string path, line_number, line_offset;
+  std::smatch sm;
+  if(std::regex_match(line, sm, link_regex)) {
+    for(size_t sub = 1; sub < link_regex.mark_count();) {
+      size_t subs = sub == 1 || sub == 5 || sub == 24 ? 4 : 3;
+      if(sm.length(sub + 1)) {
+        // The MSVC column is optional
+        if(subs == 4 && !sm.length(sub + 3))
+          subs = 3;
+        start_position = sm.position(sub + 1) - sm.length(sub);
+        end_position = sm.position(sub + subs - 1) + sm.length(sub + subs - 1);
+        if(sm.length(sub))
+          path += sm[sub].str();
+        path += sm[sub + 1].str();
+        line_number = sm[sub + 2].str();
+        line_offset = subs == 4 ? sm[sub + 3].str() : "1";
+        break;
+      }
+      sub += subs;
+    }
+  }
+  return std::make_tuple(start_position, end_position, path, line_number, line_offset);
+}
+
 int main() {
   auto app = Gtk::Application::create();
 
@@ -38,4 +75,67 @@ int main() {
     assert(std::get<2>(link) == "~/test/test.cc");
     assert(std::get<3>(link) == "36");
   }
+  {
+    auto link = Terminal::get().find_link("C:\\test\\test.cpp(12,5): error C2065: 'a': undeclared identifier");
+    assert(std::get<0>(link) == 0);
+    assert(std::get<1>(link) == 21);
+    assert(std::get<2>(link) == "C:\\test\\test.cpp");
+    assert(std::get<3>(link) == "12");
+    assert(std::get<4>(link) == "5");
+  }
+  {
+    std::vector<std::string> corpus = {
+        "~/test/test.cc:7:41: error: expected ';' after expression.",
+        "C:/test/test.cc:7:41: warning: unused variable 'a'",
+        "C:12:3: note: drive letter or file name",
+        "  --> src/main.rs:3:5",
+        "Assertion failed: (false), function main, file ~/test/test.cc, line 15.",
+        "Assertion failed: file a, file C:\\test\\test.cc, line 15.",
+        "test: ~/examples/main.cpp:17: int main(int, char**): Assertion `false' failed.",
+        "ERROR:~/test/test.cc:36:int main(): assertion failed: (false)",
+        "/home/test/test.js:12",
+        "C:/test/test.js:12",
+        "  File \"/home/test/test.py\", line 3, in <module>",
+        "  File \"C:\\test\\test.py\", line 3, in <module>",
+        "C:\\test\\test.cpp(12,5): error C2065: 'a': undeclared identifier",
+        "C:\\Program Files (x86)\\test\\test.h(3): warning C4996: 'strcpy': This function or variable may be unsafe.",
+        "test\\test.cpp(7): note: see declaration of 'a'",
+        "test(1,2,3): error C2065",
+        "test(1): error\r",
+        "[ 50%] Building CXX object src/CMakeFiles/test.dir/test.cc.o",
+        "~/test/test.cc:7:41: error\r",
+        "",
+    };
+    // Lines combined from parts of the link formats
+    std::vector<std::string> parts = {"C:", "D", "/", "\\", ":", ": ", "1", "23", ".", " ", "  --> ", "Assertion failed: ", "file ", ", line ",
+                                      " Assertion ", " failed.", "ERROR:", "  File \"", "\"", "\", line ", ", in ", "\r", "a", "\u00e6", "~/test/test.cc",
+                                      "(", "(1", ",", ",2", ")", "): "};
+    std::mt19937 random(0);
+    for(size_t c = 0; c < 100000; ++c) {
+      std::string line;
+      for(auto count = random() % 10; count > 0; --count)
+        line += parts[random() % parts.size()];
+      corpus.emplace_back(std::move(line));
+    }
+    for(auto &line : corpus)
+      assert(Terminal::get().find_link(line) == find_link_regex(line));
+  }
+  {
+    auto buffer = Terminal::get().get_buffer();
+    Terminal::get().clear();
+    Terminal::get().async_print("first\n");
+    Terminal::get().async_print("second\n");
+    assert(buffer->get_text() == "");
+    // Pending output is inserted before the printed message
+    Terminal::get().print("~/test/test.cc:7:41: error: expected ';' after expression.\n");
+    assert(buffer->get_text() == "first\nsecond\n~/test/test.cc:7:41: error: expected ';' after expression.\n");
+    assert(!buffer->get_iter_at_line(1).has_tag(Terminal::get().link_tag));
+    assert(buffer->get_iter_at_line(2).has_tag(Terminal::get().link_tag));
+    assert(Terminal::get().links.size() == 1);
+    assert(Terminal::get().links.begin()->second.path == "~/test/test.cc");
+    assert(Terminal::get().links.begin()->second.line == "7");
+    assert(Terminal::get().links.begin()->second.line_offset == "41");
+    assert(Terminal::get().build_diagnostics.diagnostics.size() == 1);
+    assert(Terminal::get().build_diagnostics.diagnostics[0].line == 7);
+  }
 }
@@ -0,0 +1,49 @@
+#include "project_files.h"
+#include "trigram_index.h"
+#include <chrono>
+#include <gtkmm.h>
+#include <iostream>
+
+/// Reports the size of the trigram index of a project, and the query latency.
+/// Usage: trigram_index_benchmark [project path] [query]...
+int main(int argc, char *argv[]) {
+  auto app = Gtk::Application::create();
+
+  boost::filesystem::path project_path = argc > 1 ? argv[1] : boost::filesystem::path(JUCI_TESTS_PATH).parent_path();
+  std::vector<std::string> queries;
+  for(int c = 2; c < argc; ++c)
+    queries.emplace_back(argv[c]);
+  if(queries.empty())
+    queries = {"include", "std::vector", "get_candidates", "not found anywhere"};
+
+  auto paths = ProjectFiles::get_paths(project_path);
+  using clock = std::chrono::steady_clock;
+  auto start = clock::now();
+  auto files = ProjectFiles::get_files(paths.project_path, paths.build_path, paths.debug_path);
+  std::cout << "Project files: " << files->size() << " files in " << std::chrono::duration<double>(clock::now() - start).count() << " s" << std::endl;
+
+  start = clock::now();
+  TrigramIndex::get_candidates(paths.project_path, paths.build_path, paths.debug_path, "abc");
+  std::cout << "Index update: " << std::chrono::duration<double>(clock::now() - start).count() << " s" << std::endl;
+
+  {
+    LockGuard lock(TrigramIndex::indices_mutex);
+    auto &index = TrigramIndex::indices[paths.project_path];
+    size_t trigrams = 0, bytes = 0;
+    for(auto &file : index.files) {
+      trigrams += file.second.trigrams.size();
+      bytes += file.first.size() + sizeof(TrigramIndex::File) + file.second.trigrams.size() * sizeof(uint16_t);
+    }
+    std::cout << "Index size: " << index.files.size() << " files, " << trigrams << " trigrams, " << bytes / 1024 << " KiB" << std::endl;
+  }
+
+  for(auto &query : queries) {
+    const size_t runs = 10;
+    size_t candidates = 0;
+    start = clock::now();
+    for(size_t c = 0; c < runs; ++c)
+      candidates = TrigramIndex::get_candidates(paths.project_path, paths.build_path, paths.debug_path, query)->size();
+    auto seconds = std::chrono::duration<double>(clock::now() - start).count() / runs;
+    std::cout << "Query \"" << query << "\": " << candidates << " candidates in " << seconds * 1000.0 << " ms" << std::endl;
+  }
+}
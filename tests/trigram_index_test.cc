@@ -0,0 +1,70 @@
+#include "trigram_index.h"
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <glib.h>
+#include <gtkmm.h>
+
+int main() {
+  auto app = Gtk::Application::create();
+
+  {
+    auto trigrams = TrigramIndex::get_trigrams("abcdAbC", 7);
+    g_assert_cmpuint(trigrams.size(), ==, 4); // abc, bcd, cda, dab
+    g_assert(std::is_sorted(trigrams.begin(), trigrams.end()));
+  }
+
+  auto tests_path = boost::filesystem::canonical(JUCI_TESTS_PATH);
+  auto project_path = tests_path / "tmp" / "trigram_index";
+  auto build_path = project_path / "build";
+  boost::filesystem::remove_all(project_path);
+  boost::filesystem::create_directories(build_path);
+
+  auto write = [&project_path](const std::string &file, const std::string &content) {
+    std::ofstream stream((project_path / file).string(), std::ofstream::binary);
+    stream << content;
+  };
+  write("main.cpp", "#include \"test.hpp\"\nint main() {\n  Test test;\n}\n");
+  write("test.hpp", "class Test {\n  int a;\n};\n");
+  write("binary.bin", std::string("\0class Test", 11));
+
+  {
+    auto candidates = TrigramIndex::get_candidates(project_path, build_path, build_path, "Test");
+    g_assert_cmpuint(candidates->size(), ==, 2);
+    g_assert((*candidates)[0] == "main.cpp");
+    g_assert((*candidates)[1] == "test.hpp");
+
+    candidates = TrigramIndex::get_candidates(project_path, build_path, build_path, "class test");
+    g_assert_cmpuint(candidates->size(), ==, 1);
+    g_assert((*candidates)[0] == "test.hpp");
+
+    candidates = TrigramIndex::get_candidates(project_path, build_path, build_path, "not found");
+    g_assert_cmpuint(candidates->size(), ==, 0);
+
+    // Short literals cannot be looked up
+    candidates = TrigramIndex::get_candidates(project_path, build_path, build_path, "a");
+    g_assert_cmpuint(candidates->size(), ==, 3);
+  }
+
+  // The index is stored in the build directory
+  {
+    g_assert(boost::filesystem::exists(build_path / ".juci_trigrams"));
+    TrigramIndex::Index index;
+    index.index_path = build_path / ".juci_trigrams";
+    TrigramIndex::read_index(index);
+    g_assert_cmpuint(index.files.size(), ==, 3);
+    LockGuard lock(TrigramIndex::indices_mutex);
+    g_assert(index.files["test.hpp"].trigrams == TrigramIndex::indices[project_path].files["test.hpp"].trigrams);
+  }
+
+  // Changed files are read again
+  {
+    write("main.cpp", "int main() {}\n");
+    boost::filesystem::last_write_time(project_path / "main.cpp", std::time(nullptr) + 10);
+    auto candidates = TrigramIndex::get_candidates(project_path, build_path, build_path, "Test");
+    g_assert_cmpuint(candidates->size(), ==, 1);
+    g_assert((*candidates)[0] == "test.hpp");
+  }
+
+  boost::filesystem::remove_all(project_path);
+}
@@ -0,0 +1,17 @@
+#include "utility.h"
+#include <glib.h>
+
+int main() {
+  g_assert(to_lower_case("Test_STRING1") == "test_string1");
+
+  g_assert_cmpint(fuzzy_match_score("", "vector"), ==, 1);
+  g_assert_cmpint(fuzzy_match_score("vec", "vector"), >, 0);
+  g_assert_cmpint(fuzzy_match_score("vtr", "vector"), >, 0);
+  g_assert_cmpint(fuzzy_match_score("vecx", "vector"), ==, 0);
+  g_assert_cmpint(fuzzy_match_score("rotcev", "vector"), ==, 0);
+
+  g_assert_cmpint(fuzzy_match_score("vec", "vector"), >, fuzzy_match_score("vec", "is_valid_vector"));
+  g_assert_cmpint(fuzzy_match_score("pb", "push_back"), >, fuzzy_match_score("pb", "superb"));
+  g_assert_cmpint(fuzzy_match_score("gl", "getLine"), >, fuzzy_match_score("gl", "angle"));
+  g_assert_cmpint(fuzzy_match_score("size", "size"), >, fuzzy_match_score("size", "resize"));
+}